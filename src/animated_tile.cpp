@@ -13,22 +13,68 @@
 #include "tile_cmd.h"
 #include "viewport_func.h"
 #include "framerate_type.h"
+#include "date_func.h"
+#include "3rdparty/cpp-btree/btree_map.h"
+
+#include <unordered_map>
 
 #include "safeguards.h"
 
-/** The table/list with animated tiles. */
+/**
+ * The table/list with animated tiles, in the order in which they are animated.
+ * Removed tiles are replaced by INVALID_TILE until the list is next compacted.
+ */
 std::vector<TileIndex> _animated_tiles;
 
+/** Position of each animated tile in #_animated_tiles. */
+static std::unordered_map<TileIndex, uint> _animated_tile_index;
+
+/** For each entry of #_animated_tiles, the tick at which it next needs to be animated, or 0 if it needs to be animated every tick. */
+static std::vector<uint64> _animated_tile_wake_tick;
+
+/** Number of removed (INVALID_TILE) entries in #_animated_tiles. */
+static uint _animated_tiles_removed = 0;
+
+/** Ascending positions in #_animated_tiles of tiles which need to be animated every tick. */
+static std::vector<uint> _animated_tiles_active;
+
+/** Positions of tiles which were woken up outside of the animation loop, these are added to #_animated_tiles_active on the next tick. */
+static std::vector<uint> _animated_tiles_woken;
+
+/** Positions of waiting tiles, keyed by the tick at which they next need to be animated. Entries which no longer match #_animated_tile_wake_tick are stale. */
+static btree::btree_multimap<uint64, uint> _animated_tiles_waiting;
+
+/** Value of _scaled_tick_counter at the last call to AnimateAnimatedTiles. */
+static uint32 _animated_tiles_last_tick = 0;
+
+/** Whether AnimateAnimatedTiles is currently iterating over #_animated_tiles_active. */
+static bool _animated_tiles_looping = false;
+
+/**
+ * Make a waiting animated tile active again.
+ * @param slot the position of the tile in #_animated_tiles
+ */
+static void WakeAnimatedTile(uint slot)
+{
+	if (_animated_tile_wake_tick[slot] == 0) return;
+	_animated_tile_wake_tick[slot] = 0;
+	_animated_tiles_woken.push_back(slot);
+}
+
 /**
  * Removes the given tile from the animated tile table.
  * @param tile the tile to remove
  */
 void DeleteAnimatedTile(TileIndex tile)
 {
-	auto to_remove = std::find(_animated_tiles.begin(), _animated_tiles.end(), tile);
-	if (to_remove != _animated_tiles.end()) {
-		/* The order of the remaining elements must stay the same, otherwise the animation loop may miss a tile. */
-		_animated_tiles.erase(to_remove);
+	auto it = _animated_tile_index.find(tile);
+	if (it != _animated_tile_index.end()) {
+		/* The order of the remaining elements must stay the same, otherwise the animation loop may miss a tile.
+		 * Leave a hole which is skipped by the animation loop, and removed when the table is compacted. */
+		_animated_tiles[it->second] = INVALID_TILE;
+		_animated_tile_wake_tick[it->second] = 0;
+		_animated_tile_index.erase(it);
+		_animated_tiles_removed++;
 		MarkTileDirtyByTile(tile, ZOOM_LVL_DRAW_MAP);
 	}
 }
@@ -41,7 +87,133 @@ void DeleteAnimatedTile(TileIndex tile)
 void AddAnimatedTile(TileIndex tile)
 {
 	MarkTileDirtyByTile(tile, ZOOM_LVL_DRAW_MAP);
-	include(_animated_tiles, tile);
+
+	auto result = _animated_tile_index.insert({ tile, (uint)_animated_tiles.size() });
+	if (!result.second) {
+		/* Already animated, the state of the tile may have changed so make sure that it is looked at again. */
+		WakeAnimatedTile(result.first->second);
+		return;
+	}
+
+	/* A new tile always has the highest position, so the active list stays sorted.
+	 * If the animation loop is running, this also makes it animate the new tile during this tick. */
+	_animated_tiles_active.push_back((uint)_animated_tiles.size());
+	_animated_tiles.push_back(tile);
+	_animated_tile_wake_tick.push_back(0);
+}
+
+/**
+ * Declare that an animated tile does not need to be animated again until the next
+ * tick at which _scaled_tick_counter is a multiple of 1 << \a speed.
+ * This only holds until the tile is animated the next time, at which point it has to be declared again.
+ * The animate tile proc of the tile must not do anything on the ticks in between.
+ * @param tile the animated tile
+ * @param speed the animation speed, as used by #AnimationInfo::speed
+ */
+void ScheduleAnimatedTile(TileIndex tile, uint8 speed)
+{
+	if (speed == 0) return;
+
+	auto it = _animated_tile_index.find(tile);
+	if (it == _animated_tile_index.end()) return;
+
+	const uint64 wake_tick = ((uint64)_scaled_tick_counter | ((1 << speed) - 1)) + 1;
+	_animated_tile_wake_tick[it->second] = wake_tick;
+	_animated_tiles_waiting.insert({ wake_tick, it->second });
+}
+
+/**
+ * Remove the holes left behind by removed tiles from the animated tile table.
+ */
+void CompactAnimatedTiles()
+{
+	assert(!_animated_tiles_looping);
+	if (_animated_tiles_removed == 0) return;
+
+	/* Map from old to new positions. */
+	std::vector<uint> new_slot(_animated_tiles.size(), UINT_MAX);
+	uint count = 0;
+	for (uint i = 0; i < _animated_tiles.size(); i++) {
+		if (_animated_tiles[i] == INVALID_TILE) continue;
+		new_slot[i] = count;
+		_animated_tiles[count] = _animated_tiles[i];
+		_animated_tile_wake_tick[count] = _animated_tile_wake_tick[i];
+		_animated_tile_index[_animated_tiles[count]] = count;
+		count++;
+	}
+	_animated_tiles.resize(count);
+	_animated_tile_wake_tick.resize(count);
+	_animated_tiles_removed = 0;
+
+	auto remap = [&](std::vector<uint> &slots) {
+		slots.erase(std::remove_if(slots.begin(), slots.end(), [&](uint &slot) -> bool {
+			slot = new_slot[slot];
+			return slot == UINT_MAX;
+		}), slots.end());
+	};
+	remap(_animated_tiles_active);
+	remap(_animated_tiles_woken);
+
+	_animated_tiles_waiting.clear();
+	for (uint i = 0; i < count; i++) {
+		if (_animated_tile_wake_tick[i] != 0) _animated_tiles_waiting.insert({ _animated_tile_wake_tick[i], i });
+	}
+}
+
+/**
+ * Rebuild the animated tile lookup structures after #_animated_tiles has been replaced, e.g. when loading a game.
+ * Duplicate and invalid entries are removed, and all tiles are made active.
+ */
+void RebuildAnimatedTileIndex()
+{
+	_animated_tile_index.clear();
+	_animated_tiles.erase(std::remove_if(_animated_tiles.begin(), _animated_tiles.end(), [&](TileIndex tile) -> bool {
+		return tile == INVALID_TILE || !_animated_tile_index.insert({ tile, (uint)_animated_tile_index.size() }).second;
+	}), _animated_tiles.end());
+
+	_animated_tile_wake_tick.assign(_animated_tiles.size(), 0);
+	_animated_tiles_removed = 0;
+	_animated_tiles_active.resize(_animated_tiles.size());
+	for (uint i = 0; i < _animated_tiles.size(); i++) {
+		_animated_tiles_active[i] = i;
+	}
+	_animated_tiles_woken.clear();
+	_animated_tiles_waiting.clear();
+	_animated_tiles_last_tick = _scaled_tick_counter;
+}
+
+/**
+ * Move the waiting tiles which are due in this tick to the active list, keeping it sorted.
+ */
+static void WakeDueAnimatedTiles()
+{
+	if (_scaled_tick_counter < _animated_tiles_last_tick) {
+		/* The tick counter went backwards, wake everything up as the wake ticks are no longer meaningful.
+		 * Animating a tile earlier than necessary is harmless. */
+		for (auto &it : _animated_tiles_waiting) {
+			if (_animated_tile_wake_tick[it.second] == it.first) WakeAnimatedTile(it.second);
+		}
+		_animated_tiles_waiting.clear();
+	}
+	_animated_tiles_last_tick = _scaled_tick_counter;
+
+	auto it = _animated_tiles_waiting.begin();
+	for (; it != _animated_tiles_waiting.end() && it->first <= _scaled_tick_counter; ++it) {
+		/* Skip stale entries of tiles which were removed, woken or rescheduled in the meantime. */
+		if (_animated_tile_wake_tick[it->second] == it->first) WakeAnimatedTile(it->second);
+	}
+	_animated_tiles_waiting.erase(_animated_tiles_waiting.begin(), it);
+
+	if (_animated_tiles_woken.empty()) return;
+
+	std::sort(_animated_tiles_woken.begin(), _animated_tiles_woken.end());
+	const size_t active_count = _animated_tiles_active.size();
+	_animated_tiles_active.insert(_animated_tiles_active.end(), _animated_tiles_woken.begin(), _animated_tiles_woken.end());
+	std::inplace_merge(_animated_tiles_active.begin(), _animated_tiles_active.begin() + active_count, _animated_tiles_active.end());
+
+	/* A tile which was rescheduled and then woken up again during the last loop may be present in both lists. */
+	_animated_tiles_active.erase(std::unique(_animated_tiles_active.begin(), _animated_tiles_active.end()), _animated_tiles_active.end());
+	_animated_tiles_woken.clear();
 }
 
 /**
@@ -56,9 +228,18 @@ void AnimateAnimatedTiles()
 
 	PerformanceAccumulator framerate(PFE_GL_LANDSCAPE);
 
-	const TileIndex *ti = _animated_tiles.data();
-	while (ti < _animated_tiles.data() + _animated_tiles.size()) {
-		const TileIndex curr = *ti;
+	WakeDueAnimatedTiles();
+
+	_animated_tiles_looping = true;
+
+	/* Tiles added during the loop are appended to the active list, and are animated in this tick too. */
+	for (size_t i = 0; i < _animated_tiles_active.size(); i++) {
+		const uint slot = _animated_tiles_active[i];
+		const TileIndex curr = _animated_tiles[slot];
+
+		/* Skip tiles which have been removed in the meantime. */
+		if (curr == INVALID_TILE) continue;
+
 		switch (GetTileType(curr)) {
 			case MP_HOUSE:
 				AnimateTile_Town(curr);
@@ -79,18 +260,16 @@ void AnimateAnimatedTiles()
 			default:
 				NOT_REACHED();
 		}
-
-		/* During the AnimateTile call, DeleteAnimatedTile could have been called,
-		 * deleting an element we've already processed and pushing the rest one
-		 * slot to the left. We can detect this by checking whether the index
-		 * in the current slot has changed - if it has, an element has been deleted,
-		 * and we should process the current slot again instead of going forward.
-		 * NOTE: this will still break if more than one animated tile is being
-		 *       deleted during the same AnimateTile call, but no code seems to
-		 *       be doing this anyway.
-		 */
-		if (*ti == curr) ++ti;
 	}
+
+	_animated_tiles_looping = false;
+
+	/* Drop removed tiles, and tiles which are now waiting, from the active list. */
+	_animated_tiles_active.erase(std::remove_if(_animated_tiles_active.begin(), _animated_tiles_active.end(), [](uint slot) -> bool {
+		return _animated_tiles[slot] == INVALID_TILE || _animated_tile_wake_tick[slot] != 0;
+	}), _animated_tiles_active.end());
+
+	if (_animated_tiles_removed > 64 && _animated_tiles_removed > _animated_tiles.size() / 4) CompactAnimatedTiles();
 }
 
 /**
@@ -99,4 +278,5 @@ void AnimateAnimatedTiles()
 void InitializeAnimatedTiles()
 {
 	_animated_tiles.clear();
+	RebuildAnimatedTileIndex();
 }
@@ -14,6 +14,9 @@
 
 void AddAnimatedTile(TileIndex tile);
 void DeleteAnimatedTile(TileIndex tile);
+void ScheduleAnimatedTile(TileIndex tile, uint8 speed);
+void CompactAnimatedTiles();
+void RebuildAnimatedTileIndex();
 void AnimateAnimatedTiles();
 void InitializeAnimatedTiles();
 
@@ -898,6 +898,10 @@ CommandCost DoCommandPInternal(TileIndex tile, uint32 p1, uint32 p2, uint32 cmd,
 	assert(_docommand_recursive == 0);
 	_docommand_recursive = 1;
 
+	/* Commands must not change the game state the path prefetches are solved against. */
+	extern void YapfFinishStartedPathPrefetches();
+	YapfFinishStartedPathPrefetches();
+
 	/* Reset the state. */
 	_additional_cash_required = 0;
 
@@ -997,6 +1001,12 @@ CommandCost DoCommandPInternal(TileIndex tile, uint32 p1, uint32 p2, uint32 cmd,
 	CommandCost res2 = command.Execute(tile, flags | DC_EXEC, p1, p2, text, binary_length);
 	BasePersistentStorageArray::SwitchMode(PSM_LEAVE_COMMAND);
 
+	/* Orders, timetables and scheduled dispatch are changed by route management commands. */
+	if (command.type == CMDT_ROUTE_MANAGEMENT) {
+		extern void InvalidateDepartureLists();
+		InvalidateDepartureLists();
+	}
+
 	if (cmd_id == CMD_COMPANY_CTRL) {
 		cur_company.Trash();
 		/* We are a new company                  -> Switch to new local company.
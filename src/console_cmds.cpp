@@ -47,6 +47,7 @@
 #include "town.h"
 #include "industry.h"
 #include "string_func_extra.h"
+#include "gfx_layout.h"
 #include <time.h>
 
 #include "safeguards.h"
@@ -2064,6 +2065,19 @@ DEF_CONSOLE_CMD(ConDumpCpdpStats)
 	return true;
 }
 
+DEF_CONSOLE_CMD(ConDumpLineCacheStats)
+{
+	if (argc == 0) {
+		IConsoleHelp("Dump text layout line cache stats.");
+		return true;
+	}
+
+	char buffer[1024];
+	Layouter::DumpLineCacheStats(buffer, lastof(buffer));
+	PrintLineByLine(buffer);
+	return true;
+}
+
 DEF_CONSOLE_CMD(ConVehicleStats)
 {
 	if (argc == 0) {
@@ -2655,6 +2669,7 @@ void IConsoleStdLibRegister()
 	IConsoleCmdRegister("dump_inflation", ConDumpInflation, nullptr, true);
 	IConsoleCmdRegister("dump_cpdp_stats", ConDumpCpdpStats, nullptr, true);
 	IConsoleCmdRegister("dump_veh_stats", ConVehicleStats, nullptr, true);
+	IConsoleCmdRegister("dump_line_cache_stats", ConDumpLineCacheStats, nullptr, true);
 	IConsoleCmdRegister("dump_map_stats", ConMapStats, nullptr, true);
 	IConsoleCmdRegister("dump_st_flow_stats", ConStFlowStats, nullptr, true);
 	IConsoleCmdRegister("dump_game_events", ConDumpGameEvents, nullptr, true);
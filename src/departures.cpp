@@ -793,3 +793,99 @@ DepartureList* MakeDepartureList(StationID station, const std::vector<const Vehi
 	/* Done. Phew! */
 	return result;
 }
+
+/** Version of the orders and timetables of all vehicles, changed whenever any of them changes. */
+static uint32 _departure_lists_version = 1;
+
+/**
+ * Mark the departure lists of all departures windows as having to be computed again,
+ * because the orders or timetable of a vehicle have changed.
+ */
+void InvalidateDepartureLists()
+{
+	_departure_lists_version++;
+	if (_departure_lists_version == 0) _departure_lists_version = 1;
+}
+
+/**
+ * Get the state of a vehicle which its departures depend on.
+ * @param v The vehicle.
+ * @return The state.
+ */
+static DepartureVehicleState GetDepartureVehicleState(const Vehicle *v)
+{
+	DepartureVehicleState state;
+	state.vehicle = v;
+	state.orders = v->orders.list;
+	state.order_start = _scaled_date_ticks - v->current_order_time;
+	state.lateness_counter = v->lateness_counter;
+	state.cur_real_order_index = v->cur_real_order_index;
+	state.cur_implicit_order_index = v->cur_implicit_order_index;
+	state.cur_timetable_order_index = v->cur_timetable_order_index;
+	state.current_order_type = v->current_order.GetType();
+	state.current_order_depot_action = v->current_order.IsType(OT_GOTO_DEPOT) ? v->current_order.GetDepotActionType() : ODATF_SERVICE_ONLY;
+	state.stopped_in_depot = v->IsStoppedInDepot();
+	state.carries_passengers = false;
+	for (const Vehicle *u = v; u != nullptr; u = u->Next()) {
+		if (u->cargo_cap > 0 && IsCargoInClass(u->cargo_type, CC_PASSENGERS)) {
+			state.carries_passengers = true;
+			break;
+		}
+	}
+	return state;
+}
+
+/**
+ * Get the settings the departure lists depend on, combined with the options of a departures window.
+ * @param window_options The options of the departures window.
+ * @return The combined options.
+ */
+static uint64 GetDepartureListOptions(uint16 window_options)
+{
+	uint64 options = 0;
+	SB(options, 0, 8, _settings_client.gui.max_departures);
+	SB(options, 8, 16, _settings_client.gui.max_departure_time);
+	SB(options, 24, 8, _settings_client.gui.departure_conditionals);
+	SB(options, 32, 1, _settings_client.gui.departure_show_all_stops);
+	SB(options, 33, 1, _settings_client.gui.departure_merge_identical);
+	SB(options, 34, 1, _settings_client.gui.departure_smart_terminus);
+	SB(options, 40, 8, _settings_game.economy.day_length_factor);
+	SB(options, 48, 16, window_options);
+	return options;
+}
+
+/**
+ * Check whether departure lists computed from this state would still be computed the same way.
+ * The scheduled dates of departures are absolute and only move when a vehicle progresses to a different order,
+ * the time of day only affects which departures fall within the window shown, so that is updated once per day.
+ * @param vehicles The vehicles of the departures window.
+ * @param window_options The options of the departures window.
+ * @return True if the departure lists do not have to be computed again.
+ */
+bool DepartureListState::IsUpToDate(const std::vector<const Vehicle *> &vehicles, uint16 window_options) const
+{
+	if (this->version != _departure_lists_version || this->date != _date) return false;
+	if (this->options != GetDepartureListOptions(window_options)) return false;
+	if (this->vehicles.size() != vehicles.size()) return false;
+
+	for (size_t i = 0; i < vehicles.size(); i++) {
+		if (!(this->vehicles[i] == GetDepartureVehicleState(vehicles[i]))) return false;
+	}
+	return true;
+}
+
+/**
+ * Record the state the departure lists of a departures window are computed from.
+ * @param vehicles The vehicles of the departures window.
+ * @param window_options The options of the departures window.
+ */
+void DepartureListState::Update(const std::vector<const Vehicle *> &vehicles, uint16 window_options)
+{
+	this->version = _departure_lists_version;
+	this->date = _date;
+	this->options = GetDepartureListOptions(window_options);
+	this->vehicles.clear();
+	for (const Vehicle *v : vehicles) {
+		this->vehicles.push_back(GetDepartureVehicleState(v));
+	}
+}
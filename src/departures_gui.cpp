@@ -98,6 +98,7 @@ protected:
 	bool departure_types[3];   ///< The types of departure to show in the departure list.
 	bool show_pax;             ///< Show passenger vehicles
 	bool show_freight;         ///< Show freight vehicles
+	DepartureListState list_state; ///< What the current departure and arrival lists were computed from.
 	bool cargo_buttons_disabled;///< Show pax/freight buttons disabled
 	uint min_width;            ///< The minimum width of this window.
 	Scrollbar *vscroll;
@@ -440,13 +441,22 @@ public:
 		/* Recompute the list of departures if we're due to. */
 		if (this->calc_tick_countdown <= 0) {
 			this->calc_tick_countdown = _settings_client.gui.departure_calc_frequency;
-			this->DeleteDeparturesList(this->departures);
-			this->DeleteDeparturesList(this->arrivals);
 			bool show_pax = _settings_client.gui.departure_only_passengers ? true : this->show_pax;
 			bool show_freight = _settings_client.gui.departure_only_passengers ? false : this->show_freight;
-			this->departures = (this->departure_types[0] ? MakeDepartureList(this->station, this->vehicles, D_DEPARTURE, Twaypoint || this->departure_types[2], show_pax, show_freight) : new DepartureList());
-			this->arrivals   = (this->departure_types[1] && !_settings_client.gui.departure_show_both ? MakeDepartureList(this->station, this->vehicles, D_ARRIVAL, false, show_pax, show_freight) : new DepartureList());
-			this->departures_invalid = false;
+			bool show_deps = this->departure_types[0];
+			bool show_via = Twaypoint || this->departure_types[2];
+			bool show_arrs = this->departure_types[1] && !_settings_client.gui.departure_show_both;
+			uint16 window_options = show_pax | (show_freight << 1) | (show_deps << 2) | (show_via << 3) | (show_arrs << 4);
+
+			/* Only simulate the orders of all vehicles again if anything the lists were computed from has changed. */
+			if (this->departures_invalid || !this->list_state.IsUpToDate(this->vehicles, window_options)) {
+				this->DeleteDeparturesList(this->departures);
+				this->DeleteDeparturesList(this->arrivals);
+				this->departures = (show_deps ? MakeDepartureList(this->station, this->vehicles, D_DEPARTURE, show_via, show_pax, show_freight) : new DepartureList());
+				this->arrivals   = (show_arrs ? MakeDepartureList(this->station, this->vehicles, D_ARRIVAL, false, show_pax, show_freight) : new DepartureList());
+				this->list_state.Update(this->vehicles, window_options);
+				this->departures_invalid = false;
+			}
 			this->SetWidgetDirty(WID_DB_LIST);
 		}
 
@@ -95,4 +95,47 @@ struct Departure {
 
 typedef std::vector<Departure*> DepartureList;
 
+/** The state of a vehicle which its departures depend on, apart from its orders and timetable. */
+struct DepartureVehicleState {
+	const Vehicle *vehicle;                            ///< The vehicle
+	const OrderList *orders;                           ///< The order list of the vehicle
+	DateTicksScaled order_start;                       ///< When the vehicle started its current order
+	int32 lateness_counter;                            ///< How late the vehicle is
+	VehicleOrderID cur_real_order_index;               ///< The current real order index of the vehicle
+	VehicleOrderID cur_implicit_order_index;           ///< The current implicit order index of the vehicle
+	VehicleOrderID cur_timetable_order_index;          ///< The current timetable order index of the vehicle
+	OrderType current_order_type;                      ///< The type of the current order of the vehicle
+	OrderDepotActionFlags current_order_depot_action;  ///< The depot action of the current order of the vehicle
+	bool stopped_in_depot;                             ///< Whether the vehicle is stopped in a depot
+	bool carries_passengers;                           ///< Whether any part of the vehicle carries passengers
+
+	inline bool operator==(const DepartureVehicleState &s) const {
+		return this->vehicle == s.vehicle &&
+				this->orders == s.orders &&
+				this->order_start == s.order_start &&
+				this->lateness_counter == s.lateness_counter &&
+				this->cur_real_order_index == s.cur_real_order_index &&
+				this->cur_implicit_order_index == s.cur_implicit_order_index &&
+				this->cur_timetable_order_index == s.cur_timetable_order_index &&
+				this->current_order_type == s.current_order_type &&
+				this->current_order_depot_action == s.current_order_depot_action &&
+				this->stopped_in_depot == s.stopped_in_depot &&
+				this->carries_passengers == s.carries_passengers;
+	}
+};
+
+/**
+ * Everything the departure lists of a departures window were computed from.
+ * As long as none of it changes, computing the lists again would yield the same departures.
+ */
+struct DepartureListState {
+	uint32 version = 0;                          ///< The departure lists version when computed, 0 if the lists have to be computed.
+	Date date = INVALID_DATE;                    ///< The date when computed.
+	uint64 options = 0;                          ///< The settings and window options used.
+	std::vector<DepartureVehicleState> vehicles; ///< The state of the vehicles used.
+
+	bool IsUpToDate(const std::vector<const Vehicle *> &vehicles, uint16 window_options) const;
+	void Update(const std::vector<const Vehicle *> &vehicles, uint16 window_options);
+};
+
 #endif /* DEPARTURES_TYPE_H */
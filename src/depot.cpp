@@ -9,6 +9,7 @@
 
 #include "stdafx.h"
 #include "depot_base.h"
+#include "depot_kdtree.h"
 #include "order_backup.h"
 #include "order_func.h"
 #include "window_func.h"
@@ -16,6 +17,7 @@
 #include "vehicle_gui.h"
 #include "vehiclelist.h"
 #include "tracerestrict.h"
+#include "rail_map.h"
 
 #include "safeguards.h"
 
@@ -23,11 +25,43 @@
 DepotPool _depot_pool("Depot");
 INSTANTIATE_POOL_METHODS(Depot)
 
+/** The tiles of all rail depots, only valid while #_rail_depot_kdtree_valid is set. */
+static RailDepotKdtree _rail_depot_kdtree(Kdtree_RailDepotXYFunc);
+static bool _rail_depot_kdtree_valid = false;
+
+/**
+ * Mark the k-d tree of rail depots as outdated, it is rebuilt when it is next used.
+ * Must be called whenever a rail depot is built or removed.
+ */
+void InvalidateRailDepotKdtree()
+{
+	_rail_depot_kdtree_valid = false;
+}
+
+/**
+ * Get the k-d tree of the tiles of all rail depots, rebuilding it if necessary.
+ * @return The k-d tree of rail depot tiles.
+ */
+const RailDepotKdtree &GetRailDepotKdtree()
+{
+	if (!_rail_depot_kdtree_valid) {
+		std::vector<TileIndex> tiles;
+		for (const Depot *d : Depot::Iterate()) {
+			if (IsRailDepotTile(d->xy)) tiles.push_back(d->xy);
+		}
+		_rail_depot_kdtree.Build(tiles.begin(), tiles.end());
+		_rail_depot_kdtree_valid = true;
+	}
+	return _rail_depot_kdtree;
+}
+
 /**
  * Clean up a depot
  */
 Depot::~Depot()
 {
+	InvalidateRailDepotKdtree();
+
 	if (CleaningPool()) return;
 
 	if (!IsDepotTile(this->xy) || GetDepotIndex(this->xy) != this->index) {
@@ -0,0 +1,22 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file depot_kdtree.h Declarations for accessing the k-d tree of rail depots */
+
+#ifndef DEPOT_KDTREE_H
+#define DEPOT_KDTREE_H
+
+#include "core/kdtree.hpp"
+#include "map_func.h"
+
+inline uint16 Kdtree_RailDepotXYFunc(TileIndex tile, int dim) { return (dim == 0) ? TileX(tile) : TileY(tile); }
+typedef Kdtree<TileIndex, decltype(&Kdtree_RailDepotXYFunc), uint16, int> RailDepotKdtree;
+
+void InvalidateRailDepotKdtree();
+const RailDepotKdtree &GetRailDepotKdtree();
+
+#endif
@@ -470,9 +470,9 @@ void ChangeOwnershipOfCompanyItems(Owner old_owner, Owner new_owner)
 				if (v->IsEngineCountable()) {
 					GroupStatistics::CountEngine(v, 1);
 				}
-				if (v->IsPrimaryVehicle() && !HasBit(v->subtype, GVSF_VIRTUAL)) {
+				if (v->IsPrimaryVehicle()) {
 					GroupStatistics::CountVehicle(v, 1);
-					v->unitnumber = unitidgen[v->type].NextID();
+					if (!HasBit(v->subtype, GVSF_VIRTUAL)) v->unitnumber = unitidgen[v->type].NextID();
 				}
 
 				/* Invalidate the vehicle's cargo payment "owner cache". */
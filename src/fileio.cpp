@@ -15,13 +15,20 @@
 #include "tar_type.h"
 #ifdef _WIN32
 #include <windows.h>
+#include <io.h>
 # define access _taccess
 #elif defined(__HAIKU__)
 #include <Path.h>
 #include <storage/FindDirectory.h>
+#include <sys/mman.h>
+#define WITH_FIO_MMAP
 #else
 #include <unistd.h>
 #include <pwd.h>
+#if !defined(__OS2__)
+#include <sys/mman.h>
+#define WITH_FIO_MMAP
+#endif
 #endif
 #include <sys/stat.h>
 #include <algorithm>
@@ -45,6 +52,9 @@ struct Fio {
 	FILE *handles[MAX_FILE_SLOTS];         ///< array of file handles we can have open
 	const char *filenames[MAX_FILE_SLOTS]; ///< array of filenames we (should) have open
 	char *shortnames[MAX_FILE_SLOTS];      ///< array of short names for spriteloader's use
+	const byte *data[MAX_FILE_SLOTS];      ///< array of the mapped (or copied) contents of the files, for #FioSlotReader
+	size_t data_size[MAX_FILE_SLOTS];      ///< array of the sizes of #data
+	bool data_mapped[MAX_FILE_SLOTS];      ///< array of whether #data is a memory mapping, or an allocated copy
 #if defined(LIMITED_FDS)
 	uint open_handles;                     ///< current amount of open handles
 	uint usage_count[MAX_FILE_SLOTS];      ///< count how many times this file has been opened
@@ -188,6 +198,97 @@ void FioReadBlock(void *ptr, size_t size)
 	_fio.pos += fread(ptr, 1, size, _fio.cur_fh);
 }
 
+/**
+ * Make the whole contents of the file of a slot available for #FioSlotReader.
+ * The file is memory mapped when the platform supports this, otherwise it is read into memory.
+ * @param slot Slot of the file.
+ * @param f Handle of the file.
+ */
+static void FioMapFileData(uint slot, FILE *f)
+{
+	_fio.data[slot] = nullptr;
+	_fio.data_size[slot] = 0;
+	_fio.data_mapped[slot] = false;
+
+	long pos = ftell(f);
+	if (fseek(f, 0, SEEK_END) < 0) return;
+	long size = ftell(f);
+	if (size <= 0) return;
+	_fio.data_size[slot] = size;
+
+#if defined(_WIN32)
+	HANDLE mapping = CreateFileMapping((HANDLE)_get_osfhandle(_fileno(f)), nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mapping != nullptr) {
+		_fio.data[slot] = (const byte *)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		CloseHandle(mapping);
+	}
+#elif defined(WITH_FIO_MMAP)
+	void *mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fileno(f), 0);
+	if (mapping != MAP_FAILED) _fio.data[slot] = (const byte *)mapping;
+#endif
+	if (_fio.data[slot] != nullptr) {
+		_fio.data_mapped[slot] = true;
+	} else {
+		DEBUG(misc, 6, "Mapping file '%s' in slot '%d' failed, reading it into memory", _fio.filenames[slot], slot);
+		byte *copy = MallocT<byte>(size);
+		fseek(f, 0, SEEK_SET);
+		_fio.data_size[slot] = fread(copy, 1, size, f);
+		_fio.data[slot] = copy;
+	}
+
+	fseek(f, pos, SEEK_SET);
+}
+
+/**
+ * Release the contents of the file of a slot made available by #FioMapFileData.
+ * @param slot Slot of the file.
+ */
+static void FioUnmapFileData(uint slot)
+{
+	if (_fio.data[slot] == nullptr) return;
+
+	if (_fio.data_mapped[slot]) {
+#if defined(_WIN32)
+		UnmapViewOfFile(_fio.data[slot]);
+#elif defined(WITH_FIO_MMAP)
+		munmap(const_cast<byte *>(_fio.data[slot]), _fio.data_size[slot]);
+#endif
+	} else {
+		free(const_cast<byte *>(_fio.data[slot]));
+	}
+	_fio.data[slot] = nullptr;
+	_fio.data_size[slot] = 0;
+}
+
+/**
+ * Create a reader for the file of a slot.
+ * @param slot Slot of the file, which must be open.
+ * @param pos Initial absolute position in the file.
+ */
+FioSlotReader::FioSlotReader(uint slot, size_t pos) : pos(pos)
+{
+#if defined(LIMITED_FDS)
+	/* Make sure we have this file open */
+	FioRestoreFile(slot);
+#endif /* LIMITED_FDS */
+	assert(_fio.handles[slot] != nullptr);
+	this->data = _fio.data[slot];
+	this->size = _fio.data_size[slot];
+}
+
+/**
+ * Read a block.
+ * @param ptr Destination buffer.
+ * @param size Number of bytes to read, bytes past the end of the file are read as 0.
+ */
+void FioSlotReader::ReadBlock(void *ptr, size_t size)
+{
+	size_t available = (this->pos < this->size) ? min(size, this->size - this->pos) : 0;
+	if (available > 0) memcpy(ptr, this->data + this->pos, available);
+	memset((byte *)ptr + available, 0, size - available);
+	this->pos += available;
+}
+
 /**
  * Close the file at the given slot number.
  * @param slot File index to close.
@@ -195,6 +296,7 @@ void FioReadBlock(void *ptr, size_t size)
 static inline void FioCloseFile(int slot)
 {
 	if (_fio.handles[slot] != nullptr) {
+		FioUnmapFileData(slot);
 		fclose(_fio.handles[slot]);
 
 		free(_fio.shortnames[slot]);
@@ -260,6 +362,7 @@ void FioOpenFile(uint slot, const char *filename, Subdirectory subdir, char **ou
 	FioCloseFile(slot); // if file was opened before, close it
 	_fio.handles[slot] = f;
 	_fio.filenames[slot] = filename;
+	FioMapFileData(slot, f);
 
 	/* Store the filename without path and extension */
 	const char *t = strrchr(filename, PATHSEPCHAR);
@@ -1208,6 +1311,8 @@ void DeterminePaths(const char *exe)
 	_hotkeys_file = str_fmt("%shotkeys.cfg", config_dir);
 	extern char *_windows_file;
 	_windows_file = str_fmt("%swindows.cfg", config_dir);
+	extern char *_newgrf_scan_cache_file;
+	_newgrf_scan_cache_file = str_fmt("%snewgrf_scan.dat", config_dir);
 
 #if defined(WITH_XDG_BASEDIR) && defined(WITH_PERSONAL_DIR)
 	if (config_dir == config_home) {
@@ -25,6 +25,70 @@ void FioOpenFile(uint slot, const char *filename, Subdirectory subdir, char **ou
 void FioReadBlock(void *ptr, size_t size);
 void FioSkipBytes(int n);
 
+/**
+ * Reader of an opened file slot, with its own read position.
+ * The data is read from a memory mapping (or a copy in memory) of the whole file, so unlike the Fio* functions,
+ * several readers can be used at the same time, also from different threads, as long as the slot stays open.
+ */
+class FioSlotReader {
+	const byte *data; ///< Contents of the whole file.
+	size_t size;      ///< Size of the contents.
+	size_t pos;       ///< Current absolute position in the file.
+
+public:
+	FioSlotReader(uint slot, size_t pos);
+
+	/**
+	 * Get position in the file.
+	 * @return Position in the file.
+	 */
+	inline size_t GetPos() const { return this->pos; }
+
+	/**
+	 * Seek to a position in the file.
+	 * @param pos New absolute position.
+	 */
+	inline void SeekTo(size_t pos) { this->pos = pos; }
+
+	/**
+	 * Skip \a n bytes ahead in the file.
+	 * @param n Number of bytes to skip reading.
+	 */
+	inline void SkipBytes(size_t n) { this->pos += n; }
+
+	/**
+	 * Read a byte from the file.
+	 * @return Read byte, or 0 when at the end of the file.
+	 */
+	inline byte ReadByte()
+	{
+		if (this->pos >= this->size) return 0;
+		return this->data[this->pos++];
+	}
+
+	/**
+	 * Read a word (16 bits) from the file (in low endian format).
+	 * @return Read word.
+	 */
+	inline uint16 ReadWord()
+	{
+		byte b = this->ReadByte();
+		return (this->ReadByte() << 8) | b;
+	}
+
+	/**
+	 * Read a double word (32 bits) from the file (in low endian format).
+	 * @return Read word.
+	 */
+	inline uint32 ReadDword()
+	{
+		uint b = this->ReadWord();
+		return (this->ReadWord() << 16) | b;
+	}
+
+	void ReadBlock(void *ptr, size_t size);
+};
+
 /**
  * The search paths OpenTTD could search through.
  * At least one of the slots has to be filled with a path.
@@ -357,6 +357,7 @@ static const NWidgetPart _framerate_window_widgets[] = {
 			NWidget(WWT_TEXT, COLOUR_GREY, WID_FRW_RATE_GAMELOOP), SetDataTip(STR_FRAMERATE_RATE_GAMELOOP, STR_FRAMERATE_RATE_GAMELOOP_TOOLTIP),
 			NWidget(WWT_TEXT, COLOUR_GREY, WID_FRW_RATE_DRAWING),  SetDataTip(STR_FRAMERATE_RATE_BLITTER,  STR_FRAMERATE_RATE_BLITTER_TOOLTIP),
 			NWidget(WWT_TEXT, COLOUR_GREY, WID_FRW_RATE_FACTOR),   SetDataTip(STR_FRAMERATE_SPEED_FACTOR,  STR_FRAMERATE_SPEED_FACTOR_TOOLTIP),
+			NWidget(WWT_TEXT, COLOUR_GREY, WID_FRW_INFO_DIRTY_BLOCKS), SetDataTip(STR_FRAMERATE_DIRTY_BLOCKS, STR_FRAMERATE_DIRTY_BLOCKS_TOOLTIP),
 		EndContainer(),
 	EndContainer(),
 	NWidget(NWID_HORIZONTAL),
@@ -421,6 +422,7 @@ struct FramerateWindow : Window {
 	CachedDecimal speed_gameloop;           ///< cached game loop speed factor
 	CachedDecimal times_shortterm[PFE_MAX]; ///< cached short term average times
 	CachedDecimal times_longterm[PFE_MAX];  ///< cached long term average times
+	DirtyBlockStats dirty_block_stats;      ///< cached dirty screen area statistics
 
 	static const int VSPACING = 3;          ///< space between column heading and values
 	static const int MIN_ELEMENTS = 5;      ///< smallest number of elements to display
@@ -465,6 +467,7 @@ struct FramerateWindow : Window {
 		if (this->small) return; // in small mode, this is everything needed
 
 		this->rate_drawing.SetRate(_pf_data[PFE_DRAWING].GetRate(), _pf_data[PFE_DRAWING].expected_rate);
+		this->dirty_block_stats = _dirty_block_stats;
 
 		int new_active = 0;
 		for (PerformanceElement e = PFE_FIRST; e < PFE_MAX; e++) {
@@ -513,6 +516,11 @@ struct FramerateWindow : Window {
 			case WID_FRW_RATE_FACTOR:
 				this->speed_gameloop.InsertDParams(0);
 				break;
+			case WID_FRW_INFO_DIRTY_BLOCKS:
+				SetDParam(0, this->dirty_block_stats.marked);
+				SetDParam(1, this->dirty_block_stats.coalesced);
+				SetDParam(2, this->dirty_block_stats.redrawn);
+				break;
 			case WID_FRW_INFO_DATA_POINTS:
 				SetDParam(0, NUM_FRAMERATE_POINTS);
 				break;
@@ -539,6 +547,12 @@ struct FramerateWindow : Window {
 				SetDParam(1, 2);
 				*size = GetStringBoundingBox(STR_FRAMERATE_SPEED_FACTOR);
 				break;
+			case WID_FRW_INFO_DIRTY_BLOCKS:
+				SetDParamMaxValue(0, 99999);
+				SetDParamMaxValue(1, 99999);
+				SetDParamMaxValue(2, 99999);
+				*size = GetStringBoundingBox(STR_FRAMERATE_DIRTY_BLOCKS);
+				break;
 
 			case WID_FRW_TIMES_NAMES: {
 				size->width = 0;
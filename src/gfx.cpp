@@ -8,6 +8,8 @@
 /** @file gfx.cpp Handling of drawing text and other gfx related stuff. */
 
 #include "stdafx.h"
+#include <algorithm>
+#include <tuple>
 #include "gfx_layout.h"
 #include "progress.h"
 #include "zoom_func.h"
@@ -23,6 +25,7 @@
 #include "widget_type.h"
 #include "window_gui.h"
 #include "framerate_type.h"
+#include "spritecache.h"
 #include "transparency.h"
 
 #include "table/palettes.h"
@@ -85,6 +88,15 @@ bool _gfx_draw_active = false;
 static std::vector<Rect> _dirty_blocks;
 static std::vector<Rect> _pending_dirty_blocks;
 
+/**
+ * Fixed cost of redrawing a separate screen rectangle, in pixels.
+ * This covers walking the window list for the rectangle and passing it to the video driver.
+ */
+static const uint DIRTY_RECT_REDRAW_OVERHEAD = DIRTY_BLOCK_WIDTH * DIRTY_BLOCK_HEIGHT * 8;
+
+DirtyBlockStats _dirty_block_stats;          ///< Dirty block statistics of the last drawn frame.
+static DirtyBlockStats _cur_dirty_block_stats; ///< Dirty block statistics of the frame being collected.
+
 /**
  * Applies a certain FillRectMode-operation to a rectangle [left, right] x [top, bottom] on the screen.
  *
@@ -1483,6 +1495,73 @@ static void DrawDirtyViewport(uint occlusion, int left, int top, int right, int
 	}
 }
 
+/**
+ * Merge the (disjoint) dirty screen rectangles which share a full edge, and replace them all by their bounding
+ * rectangle if redrawing that once is expected to be cheaper than redrawing them separately.
+ */
+static void CoalesceDirtyBlocks()
+{
+	if (_dirty_blocks.size() < 2) {
+		_cur_dirty_block_stats.coalesced += (uint)_dirty_blocks.size();
+		return;
+	}
+
+	/* Merge horizontally adjacent rectangles of the same rows, then vertically adjacent rectangles of the same columns.
+	 * The rectangles are disjoint, so merging rectangles sharing a full edge keeps them disjoint. */
+	auto merge = [](bool horizontal) {
+		std::sort(_dirty_blocks.begin(), _dirty_blocks.end(), [&](const Rect &a, const Rect &b) {
+			if (horizontal) return std::tie(a.top, a.bottom, a.left) < std::tie(b.top, b.bottom, b.left);
+			return std::tie(a.left, a.right, a.top) < std::tie(b.left, b.right, b.top);
+		});
+		size_t out = 0;
+		for (size_t i = 1; i < _dirty_blocks.size(); i++) {
+			Rect &prev = _dirty_blocks[out];
+			const Rect &r = _dirty_blocks[i];
+			if (horizontal && r.top == prev.top && r.bottom == prev.bottom && r.left == prev.right) {
+				prev.right = r.right;
+			} else if (!horizontal && r.left == prev.left && r.right == prev.right && r.top == prev.bottom) {
+				prev.bottom = r.bottom;
+			} else {
+				_dirty_blocks[++out] = r;
+			}
+		}
+		_dirty_blocks.resize(out + 1);
+	};
+	merge(true);
+	merge(false);
+
+	_cur_dirty_block_stats.coalesced += (uint)_dirty_blocks.size();
+	if (_dirty_blocks.size() < 2) return;
+
+	/* Cost model: each rectangle costs its area plus a fixed overhead. */
+	Rect bounds = _dirty_blocks[0];
+	uint64 separate_cost = 0;
+	for (const Rect &r : _dirty_blocks) {
+		bounds.left = min(bounds.left, r.left);
+		bounds.top = min(bounds.top, r.top);
+		bounds.right = max(bounds.right, r.right);
+		bounds.bottom = max(bounds.bottom, r.bottom);
+		separate_cost += (uint64)(r.right - r.left) * (r.bottom - r.top) + DIRTY_RECT_REDRAW_OVERHEAD;
+	}
+	uint64 bounds_cost = (uint64)(bounds.right - bounds.left) * (bounds.bottom - bounds.top) + DIRTY_RECT_REDRAW_OVERHEAD;
+	if (bounds_cost <= separate_cost) {
+		_dirty_blocks.clear();
+		_dirty_blocks.push_back(bounds);
+	}
+}
+
+/**
+ * Redraw the dirty screen rectangles, and clear them.
+ */
+static void RedrawDirtyBlocks()
+{
+	for (const Rect &r : _dirty_blocks) {
+		RedrawScreenRect(r.left, r.top, r.right, r.bottom);
+	}
+	_cur_dirty_block_stats.redrawn += (uint)_dirty_blocks.size();
+	_dirty_blocks.clear();
+}
+
 /**
  * Repaints the rectangle blocks which are marked as 'dirty'.
  *
@@ -1523,6 +1602,8 @@ void DrawDirtyBlocks()
 	extern void ViewportPrepareVehicleRoute();
 	ViewportPrepareVehicleRoute();
 
+	ProcessAsyncSpriteLoads();
+
 	_gfx_draw_active = true;
 
 	if (_whole_screen_dirty) {
@@ -1541,6 +1622,8 @@ void DrawDirtyBlocks()
 			cleared_overlays = true;
 		};
 
+		CoalesceDirtyBlocks();
+
 		DrawPixelInfo *old_dpi = _cur_dpi;
 		DrawPixelInfo bk;
 		_cur_dpi = &bk;
@@ -1685,9 +1768,7 @@ void DrawDirtyBlocks()
 
 		_cur_dpi = old_dpi;
 
-		for (const Rect &r : _dirty_blocks) {
-			RedrawScreenRect(r.left, r.top, r.right, r.bottom);
-		}
+		RedrawDirtyBlocks();
 	}
 
 	_dirty_blocks.clear();
@@ -1696,14 +1777,15 @@ void DrawDirtyBlocks()
 			SetDirtyBlocks(r.left, r.top, r.right, r.bottom);
 		}
 		_pending_dirty_blocks.clear();
-		for (const Rect &r : _dirty_blocks) {
-			RedrawScreenRect(r.left, r.top, r.right, r.bottom);
-		}
-		_dirty_blocks.clear();
+		CoalesceDirtyBlocks();
+		RedrawDirtyBlocks();
 	}
 	_gfx_draw_active = false;
 	++_dirty_block_colour;
 
+	_dirty_block_stats = _cur_dirty_block_stats;
+	_cur_dirty_block_stats = {};
+
 	extern void ClearViewPortCaches();
 	ClearViewPortCaches();
 }
@@ -1838,6 +1920,7 @@ void SetDirtyBlocks(int left, int top, int right, int bottom)
 	if (right > _screen.width) right = _screen.width;
 	if (bottom > _screen.height) bottom = _screen.height;
 
+	_cur_dirty_block_stats.marked++;
 	AddDirtyBlocks(0, left, top, right, bottom);
 }
 
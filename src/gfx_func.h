@@ -138,6 +138,15 @@ void SetPendingDirtyBlocks(int left, int top, int right, int bottom);
 void UnsetDirtyBlocks(int left, int top, int right, int bottom);
 void MarkWholeScreenDirty();
 
+/** Statistics of the dirty screen areas of a drawn frame. */
+struct DirtyBlockStats {
+	uint marked;      ///< Number of screen areas marked dirty.
+	uint coalesced;   ///< Number of dirty rectangles after splitting and merging.
+	uint redrawn;     ///< Number of rectangles redrawn, after the choice between separate redraws or one redraw of their bounds.
+};
+
+extern DirtyBlockStats _dirty_block_stats;
+
 void GfxInitPalettes();
 void CheckBlitter();
 
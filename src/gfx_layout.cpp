@@ -32,6 +32,14 @@
 
 /** Cache of ParagraphLayout lines. */
 Layouter::LineCache *Layouter::linecache;
+size_t Layouter::linecache_memory = 0;
+uint64 Layouter::linecache_clock = 0;
+Layouter::LineCacheStats Layouter::linecache_stats = {};
+
+/** Maximum estimated memory used by the linecache, before the least recently used lines are removed. */
+static const size_t MAX_LINE_CACHE_MEMORY = 4 << 20;
+/** The estimated memory of a layout per byte of the text buffer it lays out, for glyphs, positions and runs. */
+static const size_t LINE_CACHE_LAYOUT_MEMORY_FACTOR = 4;
 
 /** Cache of Font instances. */
 Layouter::FontColourMap Layouter::fonts[FS_END];
@@ -653,6 +661,14 @@ static inline void GetLayouter(Layouter::LineCacheItem &line, const char *&str,
 	if (!fontMapping.Contains(buff - buff_begin)) {
 		fontMapping.Insert(buff - buff_begin, f);
 	}
+
+	/* Only keep the used part of the buffer, as the line will be cached. */
+	size_t length = buff - buff_begin;
+	buff_begin = ReallocT(buff_begin, length + 1);
+	buff = buff_begin + length;
+	line.buffer = buff_begin;
+	line.buffer_size = (length + 1) * sizeof(typename T::CharType);
+
 	line.layout = T::GetParagraphLayout(buff_begin, buff, fontMapping);
 	line.state_after = state;
 }
@@ -681,11 +697,13 @@ Layouter::Layouter(const char *str, int maxw, TextColour colour, FontSize fontsi
 		LineCacheItem& line = GetCachedParagraphLayout(str, lineend - str, state);
 		if (line.layout != nullptr) {
 			/* Line is in cache */
+			linecache_stats.hits++;
 			str = lineend + 1;
 			state = line.state_after;
 			line.layout->Reflow();
 		} else {
 			/* Line is new, layout it */
+			const char *old_line_str = str;
 			FontState old_state = state;
 #if defined(WITH_ICU_LX) || defined(WITH_UNISCRIBE) || defined(WITH_COCOA)
 			const char *old_str = str;
@@ -728,6 +746,12 @@ Layouter::Layouter(const char *str, int maxw, TextColour colour, FontSize fontsi
 			if (line.layout == nullptr) {
 				GetLayouter<FallbackParagraphLayoutFactory>(line, str, state);
 			}
+
+			linecache_stats.misses++;
+			linecache_memory -= line.memory;
+			line.memory = sizeof(LineCacheKey) + sizeof(LineCacheItem) + (lineend - old_line_str) + line.runs.size() * sizeof(FontMap::value_type) +
+					line.buffer_size * (1 + LINE_CACHE_LAYOUT_MEMORY_FACTOR);
+			linecache_memory += line.memory;
 		}
 
 		/* Move all lines into a local cache so we can reuse them later on more easily. */
@@ -891,7 +915,9 @@ Layouter::LineCacheItem &Layouter::GetCachedParagraphLayout(const char *str, siz
 	LineCacheKey key;
 	key.state_before = state;
 	key.str.assign(str, len);
-	return (*linecache)[key];
+	LineCacheItem &item = (*linecache)[key];
+	item.last_used = ++linecache_clock;
+	return item;
 }
 
 /**
@@ -900,15 +926,48 @@ Layouter::LineCacheItem &Layouter::GetCachedParagraphLayout(const char *str, siz
 void Layouter::ResetLineCache()
 {
 	if (linecache != nullptr) linecache->clear();
+	linecache_memory = 0;
 }
 
 /**
  * Reduce the size of linecache if necessary to prevent infinite growth.
+ * When it uses too much memory, the least recently used lines are removed.
+ * This must not be done while a Layouter exists, as it refers to the cached layouts.
  */
 void Layouter::ReduceLineCache()
 {
-	if (linecache != nullptr) {
-		/* TODO LRU cache would be fancy, but not exactly necessary */
-		if (linecache->size() > 4096) ResetLineCache();
+	if (linecache == nullptr || linecache_memory <= MAX_LINE_CACHE_MEMORY) return;
+
+	/* Remove more than strictly needed, so this is not needed again for a while. */
+	std::vector<std::pair<uint64, LineCache::iterator>> items;
+	items.reserve(linecache->size());
+	for (auto it = linecache->begin(); it != linecache->end(); ++it) {
+		items.emplace_back(it->second.last_used, it);
 	}
+	std::sort(items.begin(), items.end(), [](const std::pair<uint64, LineCache::iterator> &a, const std::pair<uint64, LineCache::iterator> &b) {
+		return a.first < b.first;
+	});
+
+	for (const auto &item : items) {
+		if (linecache_memory <= MAX_LINE_CACHE_MEMORY * 3 / 4) break;
+		linecache_memory -= item.second->second.memory;
+		linecache->erase(item.second);
+		linecache_stats.evictions++;
+	}
+}
+
+/**
+ * Write the statistics of the linecache to a buffer.
+ * @param b The buffer to write to.
+ * @param last The last element of the buffer.
+ * @return The new end of the written string.
+ */
+char *Layouter::DumpLineCacheStats(char *b, const char *last)
+{
+	uint64 lookups = linecache_stats.hits + linecache_stats.misses;
+	b += seprintf(b, last, "Lines: " PRINTF_SIZE ", estimated memory: " PRINTF_SIZE " of " PRINTF_SIZE " bytes\n",
+			linecache != nullptr ? linecache->size() : 0, linecache_memory, MAX_LINE_CACHE_MEMORY);
+	b += seprintf(b, last, "Hits: " OTTD_PRINTF64U ", misses: " OTTD_PRINTF64U ", hit rate: %u%%, evictions: " OTTD_PRINTF64U "\n",
+			linecache_stats.hits, linecache_stats.misses, lookups != 0 ? (uint)(linecache_stats.hits * 100 / lookups) : 0, linecache_stats.evictions);
+	return b;
 }
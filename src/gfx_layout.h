@@ -14,9 +14,9 @@
 #include "gfx_func.h"
 #include "core/smallmap_type.hpp"
 
-#include <map>
 #include <string>
 #include <stack>
+#include <unordered_map>
 #include <vector>
 
 #ifdef WITH_ICU_LX
@@ -156,13 +156,19 @@ class Layouter : public std::vector<std::unique_ptr<const ParagraphLayouter::Lin
 		FontState state_before;  ///< Font state at the beginning of the line.
 		std::string str;         ///< Source string of the line (including colour and font size codes).
 
-		/** Comparison operator for std::map */
-		bool operator<(const LineCacheKey &other) const
+		bool operator==(const LineCacheKey &other) const
 		{
-			if (this->state_before.fontsize != other.state_before.fontsize) return this->state_before.fontsize < other.state_before.fontsize;
-			if (this->state_before.cur_colour != other.state_before.cur_colour) return this->state_before.cur_colour < other.state_before.cur_colour;
-			if (this->state_before.colour_stack != other.state_before.colour_stack) return this->state_before.colour_stack < other.state_before.colour_stack;
-			return this->str < other.str;
+			return this->state_before.fontsize == other.state_before.fontsize && this->state_before.cur_colour == other.state_before.cur_colour &&
+					this->state_before.colour_stack == other.state_before.colour_stack && this->str == other.str;
+		}
+	};
+
+	/** Hash of a key into the linecache. The colour stack is only compared, as it is usually empty. */
+	struct LineCacheKeyHash {
+		size_t operator()(const LineCacheKey &key) const
+		{
+			size_t state = (key.state_before.fontsize << 16) ^ (key.state_before.cur_colour << 4) ^ key.state_before.colour_stack.size();
+			return std::hash<std::string>()(key.str) ^ (state * 0x9E3779B1);
 		}
 	};
 public:
@@ -170,18 +176,33 @@ public:
 	struct LineCacheItem {
 		/* Stuff that cannot be freed until the ParagraphLayout is freed */
 		void *buffer;              ///< Accessed by both ICU's and our ParagraphLayout::nextLine.
+		size_t buffer_size;        ///< Size of #buffer in bytes.
 		FontMap runs;              ///< Accessed by our ParagraphLayout::nextLine.
 
 		FontState state_after;     ///< Font state after the line.
 		ParagraphLayouter *layout; ///< Layout of the line.
 
-		LineCacheItem() : buffer(nullptr), layout(nullptr) {}
+		size_t memory;             ///< Estimated memory used by this item and its key, in bytes.
+		uint64 last_used;          ///< Value of #linecache_clock when this item was last used.
+
+		LineCacheItem() : buffer(nullptr), buffer_size(0), layout(nullptr), memory(0), last_used(0) {}
 		~LineCacheItem() { delete layout; free(buffer); }
 	};
 private:
-	typedef std::map<LineCacheKey, LineCacheItem> LineCache;
+	typedef std::unordered_map<LineCacheKey, LineCacheItem, LineCacheKeyHash> LineCache;
 	static LineCache *linecache;
 
+	/** Statistics of the use of the linecache. */
+	struct LineCacheStats {
+		uint64 hits;           ///< Number of lines of which the layout was found in the linecache.
+		uint64 misses;         ///< Number of lines which had to be laid out.
+		uint64 evictions;      ///< Number of lines removed from the linecache as it was full.
+	};
+
+	static size_t linecache_memory;       ///< Estimated memory used by the linecache, in bytes.
+	static uint64 linecache_clock;        ///< Counter of linecache accesses, for finding the least recently used lines.
+	static LineCacheStats linecache_stats;
+
 	static LineCacheItem &GetCachedParagraphLayout(const char *str, size_t len, const FontState &state);
 
 	typedef SmallMap<TextColour, Font *> FontColourMap;
@@ -197,6 +218,7 @@ public:
 	static void ResetFontCache(FontSize size);
 	static void ResetLineCache();
 	static void ReduceLineCache();
+	static char *DumpLineCacheStats(char *b, const char *last);
 };
 
 #endif /* GFX_LAYOUT_H */
@@ -22,6 +22,7 @@
 #include "clear_func.h"
 #include "tree_map.h"
 #include "scope.h"
+#include "spritecache.h"
 #include "table/tree_land.h"
 #include "blitter/32bpp_base.hpp"
 
@@ -354,6 +355,7 @@ static bool SwitchNewGRFBlitter()
 		if (BlitterFactory::GetBlitterFactory(repl_blitter) == nullptr) continue;
 
 		DEBUG(misc, 1, "Switching blitter from '%s' to '%s'... ", cur_blitter, repl_blitter);
+		DiscardAsyncSpriteLoads();
 		Blitter *new_blitter = BlitterFactory::SelectBlitter(repl_blitter);
 		if (new_blitter == nullptr) NOT_REACHED();
 		DEBUG(misc, 1, "Successfully switched to %s.", repl_blitter);
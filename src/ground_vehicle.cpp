@@ -110,7 +110,7 @@ void GroundVehicle<T, Type>::CargoChanged()
 		u->gcache.cached_slope_resistance = current_weight * u->GetSlopeSteepness() * 100;
 		u->cur_image_valid_dir = INVALID_DIR;
 	}
-	ClrBit(this->vcache.cached_veh_flags, VCF_GV_ZERO_SLOPE_RESIST);
+	this->InvalidateSlopeResistance();
 
 	/* Store consist weight in cache. */
 	this->gcache.cached_weight = max<uint32>(1, weight);
@@ -296,11 +296,13 @@ void GroundVehicle<T, Type>::UpdateZPositionInWormhole()
 
 	TileIndex pos_tile = TileVirtXY(this->x_pos, this->y_pos);
 
+	uint16 old_gv_flags = this->gv_flags;
 	ClrBit(this->gv_flags, GVF_GOINGUP_BIT);
 	ClrBit(this->gv_flags, GVF_GOINGDOWN_BIT);
 
 	if (pos_tile == t->tile_n || pos_tile == t->tile_s) {
 		this->z_pos = 0;
+		this->InclinationChanged(old_gv_flags);
 		return;
 	}
 
@@ -331,16 +333,15 @@ void GroundVehicle<T, Type>::UpdateZPositionInWormhole()
 		if (delta != 2) {
 			slope = slope_north;
 			SetBit(this->gv_flags, going_north ? GVF_GOINGUP_BIT : GVF_GOINGDOWN_BIT);
-			ClrBit(this->First()->vcache.cached_veh_flags, VCF_GV_ZERO_SLOPE_RESIST);
 		}
 	} else if ((delta = south_coord - pos_coord) <= 3) {
 		this->z_pos = TILE_HEIGHT * (delta == 3 ? -2 : -1);
 		if (delta != 2) {
 			slope = SLOPE_ELEVATED ^ slope_north;
 			SetBit(this->gv_flags, going_north ? GVF_GOINGDOWN_BIT : GVF_GOINGUP_BIT);
-			ClrBit(this->First()->vcache.cached_veh_flags, VCF_GV_ZERO_SLOPE_RESIST);
 		}
 	}
+	this->InclinationChanged(old_gv_flags);
 
 	if (slope != SLOPE_FLAT) this->z_pos += GetPartialPixelZ(this->x_pos & 0xF, this->y_pos & 0xF, slope);
 }
@@ -81,6 +81,7 @@ template <class T, VehicleType Type>
 struct GroundVehicle : public SpecializedVehicle<T, Type> {
 	GroundVehicleCache gcache; ///< Cache of often calculated values.
 	uint16 gv_flags;           ///< @see GroundVehicleFlags.
+	int64 cached_total_slope_resistance; ///< Slope resistance of the whole consist (valid only for the first engine, if #VCF_GV_SLOPE_RESIST_VALID is set).
 
 	typedef GroundVehicle<T, Type> GroundVehicleBase; ///< Our type
 
@@ -106,36 +107,83 @@ struct GroundVehicle : public SpecializedVehicle<T, Type> {
 	{
 		/* Crashed vehicles aren't going up or down */
 		for (T *v = T::From(this); v != nullptr; v = v->Next()) {
-			ClrBit(v->gv_flags, GVF_GOINGUP_BIT);
-			ClrBit(v->gv_flags, GVF_GOINGDOWN_BIT);
+			v->ClearInclination();
 		}
 		return this->Vehicle::Crash(flooded);
 	}
 
+	/**
+	 * Get the slope resistance this vehicle part contributes to the consist.
+	 * @param gv_flags The ground vehicle flags of this vehicle part.
+	 * @return Slope resistance, negative when going downhill.
+	 */
+	inline int64 GetPartSlopeResistance(uint16 gv_flags) const
+	{
+		if (HasBit(gv_flags, GVF_GOINGUP_BIT)) return this->gcache.cached_slope_resistance;
+		if (HasBit(gv_flags, GVF_GOINGDOWN_BIT)) return -(int64)this->gcache.cached_slope_resistance;
+		return 0;
+	}
+
+	/**
+	 * Update the cached slope resistance of the consist after the inclination of this vehicle part changed.
+	 * Only the change of this part is applied, so the consist does not have to be walked again.
+	 * @param old_gv_flags The ground vehicle flags of this vehicle part before the change.
+	 */
+	inline void InclinationChanged(uint16 old_gv_flags)
+	{
+		int64 delta = this->GetPartSlopeResistance(this->gv_flags) - this->GetPartSlopeResistance(old_gv_flags);
+		if (delta == 0) return;
+
+		GroundVehicle *front = T::From(this)->First();
+		front->cached_total_slope_resistance += delta;
+		ClrBit(front->vcache.cached_veh_flags, VCF_GV_ZERO_SLOPE_RESIST);
+	}
+
+	/**
+	 * Clear the going up and going down flags of this vehicle part, and update the cached slope resistance of the consist.
+	 */
+	inline void ClearInclination()
+	{
+		uint16 old_gv_flags = this->gv_flags;
+		ClrBit(this->gv_flags, GVF_GOINGUP_BIT);
+		ClrBit(this->gv_flags, GVF_GOINGDOWN_BIT);
+		this->InclinationChanged(old_gv_flags);
+	}
+
 	/**
 	 * Calculates the total slope resistance for this vehicle.
+	 * The total is cached, and kept up to date by #InclinationChanged when a vehicle part changes its inclination.
+	 * It is only recalculated from all vehicle parts after the weights or the order of the parts changed.
 	 * @return Slope resistance.
 	 */
 	inline int64 GetSlopeResistance()
 	{
 		if (likely(HasBit(this->vcache.cached_veh_flags, VCF_GV_ZERO_SLOPE_RESIST))) return 0;
+		if (likely(HasBit(this->vcache.cached_veh_flags, VCF_GV_SLOPE_RESIST_VALID))) return this->cached_total_slope_resistance;
 
 		int64 incl = 0;
 		bool zero_slope_resist = true;
 
 		for (const T *u = T::From(this); u != nullptr; u = u->Next()) {
-			if (HasBit(u->gv_flags, GVF_GOINGUP_BIT)) {
-				incl += u->gcache.cached_slope_resistance;
-			} else if (HasBit(u->gv_flags, GVF_GOINGDOWN_BIT)) {
-				incl -= u->gcache.cached_slope_resistance;
-			}
+			incl += u->GetPartSlopeResistance(u->gv_flags);
 			if (incl != 0) zero_slope_resist = false;
 		}
 		SB(this->vcache.cached_veh_flags, VCF_GV_ZERO_SLOPE_RESIST, 1, zero_slope_resist ? 1 : 0);
+		SetBit(this->vcache.cached_veh_flags, VCF_GV_SLOPE_RESIST_VALID);
+		this->cached_total_slope_resistance = incl;
 
 		return incl;
 	}
 
+	/**
+	 * Invalidate the cached slope resistance of the consist, after the weights, inclinations or order of the vehicle parts changed other than by #InclinationChanged.
+	 */
+	inline void InvalidateSlopeResistance()
+	{
+		ClrBit(this->vcache.cached_veh_flags, VCF_GV_ZERO_SLOPE_RESIST);
+		ClrBit(this->vcache.cached_veh_flags, VCF_GV_SLOPE_RESIST_VALID);
+	}
+
 	/**
 	 * Updates vehicle's Z position and inclination.
 	 * Used when the vehicle entered given tile.
@@ -145,6 +193,7 @@ struct GroundVehicle : public SpecializedVehicle<T, Type> {
 	inline void UpdateZPositionAndInclination()
 	{
 		this->z_pos = GetSlopePixelZ(this->x_pos, this->y_pos);
+		uint16 old_gv_flags = this->gv_flags;
 		ClrBit(this->gv_flags, GVF_GOINGUP_BIT);
 		ClrBit(this->gv_flags, GVF_GOINGDOWN_BIT);
 
@@ -157,9 +206,9 @@ struct GroundVehicle : public SpecializedVehicle<T, Type> {
 
 			if (middle_z != this->z_pos) {
 				SetBit(this->gv_flags, (middle_z > this->z_pos) ? GVF_GOINGUP_BIT : GVF_GOINGDOWN_BIT);
-				ClrBit(this->First()->vcache.cached_veh_flags, VCF_GV_ZERO_SLOPE_RESIST);
 			}
 		}
+		this->InclinationChanged(old_gv_flags);
 	}
 
 	/**
@@ -114,9 +114,14 @@ void GroupStatistics::Clear()
 	for (Group *g : Group::Iterate()) {
 		g->statistics.Clear();
 	}
+	ClearPrimaryVehicleIndex();
 
 	for (const Vehicle *v : Vehicle::Iterate()) {
-		if (!v->IsEngineCountable()) continue;
+		if (!v->IsEngineCountable()) {
+			/* Virtual vehicles are not counted, but they are in the primary vehicle indices. */
+			if (HasBit(v->subtype, GVSF_VIRTUAL) && v->IsPrimaryVehicle()) GroupStatistics::CountVehicle(v, 1);
+			continue;
+		}
 
 		GroupStatistics::CountEngine(v, 1);
 		if (v->IsPrimaryVehicle()) GroupStatistics::CountVehicle(v, 1);
@@ -134,11 +139,18 @@ void GroupStatistics::Clear()
  */
 /* static */ void GroupStatistics::CountVehicle(const Vehicle *v, int delta)
 {
+	assert(delta == 1 || delta == -1);
+
+	/* The primary vehicle indices follow the counted vehicles, so that they move with changes of the owner and group. */
+	if (delta == 1) {
+		IndexPrimaryVehicle(v);
+	} else {
+		UnindexPrimaryVehicle(v);
+	}
+
 	/* make virtual trains group-neutral */
 	if (HasBit(v->subtype, GVSF_VIRTUAL)) return;
 
-	assert(delta == 1 || delta == -1);
-
 	GroupStatistics &stats_all = GroupStatistics::GetAllGroup(v);
 	GroupStatistics &stats = GroupStatistics::Get(v);
 
@@ -564,6 +564,7 @@ void AnimateTile_Industry(TileIndex tile)
 
 	switch (gfx) {
 	case GFX_SUGAR_MINE_SIEVE:
+		ScheduleAnimatedTile(tile, 1);
 		if ((_scaled_tick_counter & 1) == 0) {
 			byte m = GetAnimationFrame(tile) + 1;
 
@@ -585,6 +586,7 @@ void AnimateTile_Industry(TileIndex tile)
 		break;
 
 	case GFX_TOFFEE_QUARY:
+		ScheduleAnimatedTile(tile, 2);
 		if ((_scaled_tick_counter & 3) == 0) {
 			byte m = GetAnimationFrame(tile);
 
@@ -603,6 +605,7 @@ void AnimateTile_Industry(TileIndex tile)
 		break;
 
 	case GFX_BUBBLE_CATCHER:
+		ScheduleAnimatedTile(tile, 1);
 		if ((_scaled_tick_counter & 1) == 0) {
 			byte m = GetAnimationFrame(tile);
 
@@ -618,6 +621,7 @@ void AnimateTile_Industry(TileIndex tile)
 
 	/* Sparks on a coal plant */
 	case GFX_POWERPLANT_SPARKS:
+		ScheduleAnimatedTile(tile, 2);
 		if ((_scaled_tick_counter & 3) == 0) {
 			byte m = GetAnimationFrame(tile);
 			if (m == 6) {
@@ -631,6 +635,7 @@ void AnimateTile_Industry(TileIndex tile)
 		break;
 
 	case GFX_TOY_FACTORY:
+		ScheduleAnimatedTile(tile, 1);
 		if ((_scaled_tick_counter & 1) == 0) {
 			byte m = GetAnimationFrame(tile) + 1;
 
@@ -659,6 +664,7 @@ void AnimateTile_Industry(TileIndex tile)
 	case GFX_PLASTIC_FOUNTAIN_ANIMATED_3: case GFX_PLASTIC_FOUNTAIN_ANIMATED_4:
 	case GFX_PLASTIC_FOUNTAIN_ANIMATED_5: case GFX_PLASTIC_FOUNTAIN_ANIMATED_6:
 	case GFX_PLASTIC_FOUNTAIN_ANIMATED_7: case GFX_PLASTIC_FOUNTAIN_ANIMATED_8:
+		ScheduleAnimatedTile(tile, 2);
 		if ((_scaled_tick_counter & 3) == 0) {
 			IndustryGfx gfx = GetIndustryGfx(tile);
 
@@ -671,6 +677,7 @@ void AnimateTile_Industry(TileIndex tile)
 	case GFX_OILWELL_ANIMATED_1:
 	case GFX_OILWELL_ANIMATED_2:
 	case GFX_OILWELL_ANIMATED_3:
+		ScheduleAnimatedTile(tile, 3);
 		if ((_scaled_tick_counter & 7) == 0) {
 			bool b = Chance16(1, 7);
 			IndustryGfx gfx = GetIndustryGfx(tile);
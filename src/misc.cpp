@@ -37,6 +37,8 @@
 #include "command_func.h"
 #include "zoning.h"
 #include "cargopacket.h"
+#include "pathfinder/yapf/yapf.h"
+#include "pathfinder/yapf/yapf_cache.h"
 
 #include "safeguards.h"
 
@@ -68,7 +70,10 @@ void InitializeGame(uint size_x, uint size_y, bool reset_date, bool reset_settin
 	 * related to the new game we're about to start/load. */
 	UnInitWindowSystem();
 
+	YapfStopPathPrefetchers();
+
 	AllocateMap(size_x, size_y);
+	YapfNotifyTrackLayoutChange(INVALID_TILE, INVALID_TRACK);
 
 	ViewportMapClearTunnelCache();
 	ClearCommandLog();
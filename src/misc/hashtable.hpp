@@ -11,6 +11,7 @@
 #define HASHTABLE_HPP
 
 #include "../core/math_func.hpp"
+#include "../core/mem_func.hpp"
 
 template <class Titem_>
 struct CHashTableSlotT
@@ -146,13 +147,32 @@ protected:
 	 */
 	typedef CHashTableSlotT<Titem_> Slot;
 
-	Slot  m_slots[Tcapacity]; // here we store our data (array of blobs)
-	int   m_num_items;        // item counter
+	Slot   m_slots[Tcapacity];           // here we store our data (array of blobs)
+	uint32 m_slot_generation[Tcapacity]; // generation in which each slot was last used, slots of older generations are empty
+	uint32 m_generation;                 // current generation, incremented to clear all slots at once
+	int    m_num_items;                  // item counter
+
+	/** return the slot for the given hash, clearing it if it is of an older generation */
+	inline Slot &GetSlot(int hash)
+	{
+		if (m_slot_generation[hash] != m_generation) {
+			m_slots[hash].Clear();
+			m_slot_generation[hash] = m_generation;
+		}
+		return m_slots[hash];
+	}
+
+	/** return the slot for the given hash, or nullptr if it is of an older generation and thus empty */
+	inline const Slot *GetSlot(int hash) const
+	{
+		return m_slot_generation[hash] == m_generation ? &m_slots[hash] : nullptr;
+	}
 
 public:
 	/* default constructor */
-	inline CHashTableT() : m_num_items(0)
+	inline CHashTableT() : m_generation(1), m_num_items(0)
 	{
+		MemSetT(m_slot_generation, 0, Tcapacity);
 	}
 
 protected:
@@ -179,18 +199,25 @@ public:
 		return m_num_items;
 	}
 
-	/** simple clear - forget all items - used by CSegmentCostCacheT.Flush() */
+	/** simple clear - forget all items - used by CSegmentCostCacheT.Flush() and the node lists
+	 *  Only touches the slots when the generation counter wraps around. */
 	inline void Clear()
 	{
-		for (int i = 0; i < Tcapacity; i++) m_slots[i].Clear();
+		m_num_items = 0;
+		if (++m_generation == 0) {
+			for (int i = 0; i < Tcapacity; i++) m_slots[i].Clear();
+			MemSetT(m_slot_generation, 0, Tcapacity);
+			m_generation = 1;
+		}
 	}
 
 	/** const item search */
 	const Titem_ *Find(const Tkey &key) const
 	{
 		int hash = CalcHash(key);
-		const Slot &slot = m_slots[hash];
-		const Titem_ *item = slot.Find(key);
+		const Slot *slot = GetSlot(hash);
+		if (slot == nullptr) return nullptr;
+		const Titem_ *item = slot->Find(key);
 		return item;
 	}
 
@@ -198,6 +225,7 @@ public:
 	Titem_ *Find(const Tkey &key)
 	{
 		int hash = CalcHash(key);
+		if (m_slot_generation[hash] != m_generation) return nullptr;
 		Slot &slot = m_slots[hash];
 		Titem_ *item = slot.Find(key);
 		return item;
@@ -207,7 +235,7 @@ public:
 	Titem_ *TryPop(const Tkey &key)
 	{
 		int hash = CalcHash(key);
-		Slot &slot = m_slots[hash];
+		Slot &slot = GetSlot(hash);
 		Titem_ *item = slot.Detach(key);
 		if (item != nullptr) {
 			m_num_items--;
@@ -228,7 +256,7 @@ public:
 	{
 		const Tkey &key = item.GetKey();
 		int hash = CalcHash(key);
-		Slot &slot = m_slots[hash];
+		Slot &slot = GetSlot(hash);
 		bool ret = slot.Detach(item);
 		if (ret) {
 			m_num_items--;
@@ -247,7 +275,7 @@ public:
 	void Push(Titem_ &new_item)
 	{
 		int hash = CalcHash(new_item);
-		Slot &slot = m_slots[hash];
+		Slot &slot = GetSlot(hash);
 		assert(slot.Find(new_item.GetKey()) == nullptr);
 		slot.Attach(new_item);
 		m_num_items++;
@@ -93,6 +93,7 @@ enum PacketGameType {
 	/* Sending commands around. */
 	PACKET_CLIENT_COMMAND,               ///< Client executed a command and sends it to the server.
 	PACKET_SERVER_COMMAND,               ///< Server distributes a command to (all) the clients.
+	PACKET_SERVER_COMMAND_BATCH,         ///< Server distributes all commands of a single frame to (all) the clients.
 
 	/* Human communication! */
 	PACKET_CLIENT_CHAT,                  ///< Client said something that should be distributed.
@@ -397,6 +398,23 @@ protected:
 	 */
 	virtual NetworkRecvStatus Receive_SERVER_COMMAND(Packet *p);
 
+	/**
+	 * Sends a batch of DoCommands, all to be executed in the same frame, to the client:
+	 * uint32  Frame of execution.
+	 * uint16  Number of commands in the batch.
+	 * For each command:
+	 *   uint8   ID of the company (0..MAX_COMPANIES-1).
+	 *   uint32  ID of the command (see command.h).
+	 *   uint32  P1 (free variable used in DoCommand).
+	 *   uint32  P2.
+	 *   uint32  Tile where this is taking place.
+	 *   string  Text.
+	 *   uint8   ID of the callback.
+	 *   bool    Whether the command was sent by the receiving client.
+	 * @param p The packet that was just received.
+	 */
+	virtual NetworkRecvStatus Receive_SERVER_COMMAND_BATCH(Packet *p);
+
 	/**
 	 * Sends a chat-packet to the server:
 	 * uint8   ID of the action (see NetworkAction).
@@ -578,6 +596,7 @@ public:
 
 	const char *ReceiveCommand(Packet *p, CommandPacket *cp);
 	void SendCommand(Packet *p, const CommandPacket *cp);
+	static size_t GetSendCommandSize(const CommandPacket *cp);
 };
 
 #endif /* NETWORK_CORE_TCP_GAME_H */
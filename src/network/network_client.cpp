@@ -1069,6 +1069,31 @@ NetworkRecvStatus ClientNetworkGameSocketHandler::Receive_SERVER_COMMAND(Packet
 	return NETWORK_RECV_STATUS_OKAY;
 }
 
+NetworkRecvStatus ClientNetworkGameSocketHandler::Receive_SERVER_COMMAND_BATCH(Packet *p)
+{
+	if (this->status == STATUS_CLOSING) return NETWORK_RECV_STATUS_OKAY;
+	if (this->status != STATUS_ACTIVE) return NETWORK_RECV_STATUS_MALFORMED_PACKET;
+
+	uint32 frame = p->Recv_uint32();
+	uint count = p->Recv_uint16();
+
+	for (uint i = 0; i < count; i++) {
+		CommandPacket cp;
+		const char *err = this->ReceiveCommand(p, &cp);
+		cp.frame    = frame;
+		cp.my_cmd   = p->Recv_bool();
+
+		if (err != nullptr) {
+			IConsolePrintF(CC_ERROR, "WARNING: %s from server, dropping...", err);
+			return NETWORK_RECV_STATUS_MALFORMED_PACKET;
+		}
+
+		this->incoming_queue.Append(std::move(cp));
+	}
+
+	return NETWORK_RECV_STATUS_OKAY;
+}
+
 NetworkRecvStatus ClientNetworkGameSocketHandler::Receive_SERVER_CHAT(Packet *p)
 {
 	if (this->status == STATUS_CLOSING) return NETWORK_RECV_STATUS_OKAY;
@@ -367,3 +367,19 @@ void NetworkGameSocketHandler::SendCommand(Packet *p, const CommandPacket *cp)
 	}
 	p->Send_uint8 (callback);
 }
+
+/**
+ * Get the number of bytes which #SendCommand will write for a command.
+ * @param cp the packet to be sent.
+ * @return the size in bytes.
+ */
+size_t NetworkGameSocketHandler::GetSendCommandSize(const CommandPacket *cp)
+{
+	size_t size = sizeof(uint8) + 5 * sizeof(uint32) + sizeof(uint8);
+	if (cp->binary_length == 0) {
+		size += strlen(cp->text.c_str()) + 1;
+	} else {
+		size += cp->binary_length;
+	}
+	return size;
+}
@@ -760,6 +760,45 @@ NetworkRecvStatus ServerNetworkGameSocketHandler::SendCommand(const CommandPacke
 	return NETWORK_RECV_STATUS_OKAY;
 }
 
+/**
+ * Send the commands at the front of a queue which are to be executed in the same frame.
+ * Consecutive commands for the same frame are packed into a single packet, as long as they fit.
+ * @param queue The queue to take the commands from, it must not be empty.
+ */
+NetworkRecvStatus ServerNetworkGameSocketHandler::SendCommandBatch(CommandQueue &queue)
+{
+	const CommandPacket *first = queue.Peek();
+	assert(first != nullptr);
+	const uint32 frame = first->frame;
+
+	/* Determine how many commands fit into a single packet. */
+	uint count = 0;
+	size_t size = sizeof(PacketSize) + sizeof(PacketType) + sizeof(uint32) + sizeof(uint16);
+	for (const CommandPacket *cp = first; cp != nullptr && cp->frame == frame && count < UINT16_MAX; cp = cp->next) {
+		size_t cmd_size = NetworkGameSocketHandler::GetSendCommandSize(cp) + sizeof(bool);
+		if (size + cmd_size >= SHRT_MAX) break;
+		size += cmd_size;
+		count++;
+	}
+
+	if (count <= 1) {
+		std::unique_ptr<CommandPacket> cp = queue.Pop();
+		return this->SendCommand(cp.get());
+	}
+
+	Packet *p = new Packet(PACKET_SERVER_COMMAND_BATCH);
+	p->Send_uint32(frame);
+	p->Send_uint16(count);
+	for (uint i = 0; i < count; i++) {
+		std::unique_ptr<CommandPacket> cp = queue.Pop();
+		this->NetworkGameSocketHandler::SendCommand(p, cp.get());
+		p->Send_bool(cp->my_cmd);
+	}
+
+	this->SendPacket(p);
+	return NETWORK_RECV_STATUS_OKAY;
+}
+
 /**
  * Send a chat message.
  * @param action The action associated with the message.
@@ -1872,9 +1911,8 @@ void NetworkServerSetCompanyPassword(CompanyID company_id, const char *password,
  */
 static void NetworkHandleCommandQueue(NetworkClientSocket *cs)
 {
-	std::unique_ptr<CommandPacket> cp;
-	while ((cp = cs->outgoing_queue.Pop()) != nullptr) {
-		cs->SendCommand(cp.get());
+	while (cs->outgoing_queue.Peek() != nullptr) {
+		cs->SendCommandBatch(cs->outgoing_queue);
 	}
 }
 
@@ -11,6 +11,9 @@
 
 #include <stdarg.h>
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <map>
 
 #include "debug.h"
 #include "fileio_func.h"
@@ -47,6 +50,8 @@
 #include "language.h"
 #include "vehicle_base.h"
 #include "road.h"
+#include "spritecache.h"
+#include "thread.h"
 
 #include "table/strings.h"
 #include "table/build_industry.h"
@@ -9896,6 +9901,15 @@ byte GetGRFContainerVersion()
 	return 1;
 }
 
+/** Sprite section offsets of a NewGRF being loaded, read in advance by #PrefetchGRFSpriteOffsets. */
+struct GRFPrefetchedSpriteOffsets {
+	Subdirectory subdir;       ///< The sub directory the NewGRF was read from.
+	GRFSpriteOffsets offsets;  ///< The sprite section offsets.
+};
+
+/** Sprite section offsets of the NewGRFs being loaded, read in advance by #PrefetchGRFSpriteOffsets. */
+static std::map<const GRFConfig *, GRFPrefetchedSpriteOffsets> _grf_prefetched_sprite_offsets;
+
 /**
  * Load a particular NewGRF.
  * @param config     The configuration of the to be loaded NewGRF.
@@ -9949,7 +9963,13 @@ void LoadNewGRFFile(GRFConfig *config, uint file_index, GrfLoadingStage stage, S
 	if (stage == GLS_INIT || stage == GLS_ACTIVATION) {
 		/* We need the sprite offsets in the init stage for NewGRF sounds
 		 * and in the activation stage for real sprites. */
-		ReadGRFSpriteOffsets(_cur.grf_container_ver);
+		auto prefetched = _grf_prefetched_sprite_offsets.find(config);
+		if (_cur.grf_container_ver >= 2 && prefetched != _grf_prefetched_sprite_offsets.end() && prefetched->second.subdir == subdir) {
+			FioReadDword();
+			SetGRFSpriteOffsets(prefetched->second.offsets);
+		} else {
+			ReadGRFSpriteOffsets(_cur.grf_container_ver);
+		}
 	} else {
 		/* Skip sprite section offset if present. */
 		if (_cur.grf_container_ver >= 2) FioReadDword();
@@ -10306,6 +10326,66 @@ static void AfterLoadGRFs()
 	_grm_sprites.clear();
 }
 
+/**
+ * Read the sprite sections of all NewGRFs to be loaded, using multiple threads.
+ * Unlike the pseudo sprites, which have to be processed in order as NewGRFs may
+ * depend on the results of earlier NewGRFs, the sprite sections are independent.
+ * They are needed by both the init and activation stages.
+ * @param file_index The Fio index of the first NewGRF to load.
+ * @param num_baseset Number of NewGRFs at the front of the list to look up in the baseset dir instead of the newgrf dir.
+ */
+static void PrefetchGRFSpriteOffsets(uint file_index, uint num_baseset)
+{
+	struct PrefetchJob {
+		const GRFConfig *config;
+		Subdirectory subdir;
+		FILE *f;
+		GRFSpriteOffsets offsets;
+		bool success;
+	};
+
+	/* Open the files up front, so the threads only have to read them.
+	 * The files are assigned to slots, which decide their sub directory, like the init stage of #LoadNewGRF does. */
+	std::vector<PrefetchJob> jobs;
+	uint slot = file_index;
+	for (const GRFConfig *c = _grfconfig; c != nullptr; c = c->next) {
+		if (c->status == GCS_DISABLED || c->status == GCS_NOT_FOUND) continue;
+
+		Subdirectory subdir = slot < file_index + num_baseset ? BASESET_DIR : NEWGRF_DIR;
+		if (!FioCheckFileExists(c->filename, subdir)) continue;
+		if (!HasBit(c->flags, GCF_STATIC) && !HasBit(c->flags, GCF_SYSTEM) && slot == MAX_FILE_SLOTS) continue;
+
+		if (slot++ >= MAX_FILE_SLOTS) continue;
+		FILE *f = FioFOpenFile(c->filename, "rb", subdir);
+		if (f != nullptr) jobs.push_back({ c, subdir, f, GRFSpriteOffsets(), false });
+	}
+
+	std::atomic<size_t> next_job(0);
+	auto prefetch = [&]() {
+		for (size_t i = next_job++; i < jobs.size(); i = next_job++) {
+			jobs[i].success = ReadGRFSpriteOffsetsFromFile(jobs[i].f, jobs[i].offsets);
+		}
+	};
+
+	std::vector<std::thread> threads;
+	uint num_threads = min<uint>(std::thread::hardware_concurrency(), (uint)jobs.size());
+	for (uint i = 1; i < num_threads; i++) {
+		std::thread thread;
+		if (!StartNewThread(&thread, "ottd:grf-offsets", [&]() { prefetch(); })) break;
+		threads.push_back(std::move(thread));
+	}
+	prefetch();
+	for (std::thread &thread : threads) {
+		thread.join();
+	}
+
+	for (PrefetchJob &job : jobs) {
+		FioFCloseFile(job.f);
+		/* On failure the file is read the usual way, which also reports any errors. */
+		if (job.success) _grf_prefetched_sprite_offsets[job.config] = { job.subdir, std::move(job.offsets) };
+	}
+}
+
 /**
  * Load all the NewGRFs.
  * @param load_index The offset for the first sprite to add.
@@ -10352,6 +10432,15 @@ void LoadNewGRF(uint load_index, uint file_index, uint num_baseset)
 
 	_cur.spriteid = load_index;
 
+	/* Time spent per NewGRF and loading stage, for the startup timing breakdown. */
+	typedef std::chrono::steady_clock::duration GRFStageTimes[GLS_END];
+	std::map<const GRFConfig *, GRFStageTimes> grf_times;
+	GRFStageTimes stage_times = {};
+	auto start_time = std::chrono::steady_clock::now();
+
+	PrefetchGRFSpriteOffsets(file_index, num_baseset);
+	auto prefetch_time = std::chrono::steady_clock::now() - start_time;
+
 	/* Load newgrf sprites
 	 * in each loading stage, (try to) open each file specified in the config
 	 * and load information from it. */
@@ -10399,7 +10488,12 @@ void LoadNewGRF(uint load_index, uint file_index, uint num_baseset)
 				}
 				num_non_static++;
 			}
+			auto grf_start_time = std::chrono::steady_clock::now();
 			LoadNewGRFFile(c, slot++, stage, subdir);
+			auto grf_time = std::chrono::steady_clock::now() - grf_start_time;
+			grf_times[c][stage] += grf_time;
+			stage_times[stage] += grf_time;
+
 			if (stage == GLS_RESERVE) {
 				SetBit(c->flags, GCF_RESERVED);
 			} else if (stage == GLS_ACTIVATION) {
@@ -10417,9 +10511,28 @@ void LoadNewGRF(uint load_index, uint file_index, uint num_baseset)
 
 	/* Pseudo sprite processing is finished; free temporary stuff */
 	_cur.ClearDataForNextFile();
+	_grf_prefetched_sprite_offsets.clear();
 
 	/* Call any functions that should be run after GRFs have been loaded. */
+	auto after_load_start_time = std::chrono::steady_clock::now();
 	AfterLoadGRFs();
+	auto end_time = std::chrono::steady_clock::now();
+
+	auto to_ms = [](std::chrono::steady_clock::duration d) -> double {
+		return std::chrono::duration_cast<std::chrono::microseconds>(d).count() / 1000.0;
+	};
+	for (const GRFConfig *c = _grfconfig; c != nullptr; c = c->next) {
+		auto it = grf_times.find(c);
+		if (it == grf_times.end()) continue;
+		const GRFStageTimes &times = it->second;
+		DEBUG(grf, 2, "LoadNewGRF: %.1f ms for '%s' (label scan: %.1f ms, init: %.1f ms, reserve: %.1f ms, activation: %.1f ms)",
+				to_ms(times[GLS_LABELSCAN] + times[GLS_INIT] + times[GLS_RESERVE] + times[GLS_ACTIVATION]), c->GetDisplayPath(),
+				to_ms(times[GLS_LABELSCAN]), to_ms(times[GLS_INIT]), to_ms(times[GLS_RESERVE]), to_ms(times[GLS_ACTIVATION]));
+	}
+	DEBUG(grf, 1, "LoadNewGRF: %.1f ms for %u NewGRFs (sprite sections: %.1f ms, label scan: %.1f ms, init: %.1f ms, reserve: %.1f ms, activation: %.1f ms, finalisation: %.1f ms)",
+			to_ms(end_time - start_time), (uint)grf_times.size(), to_ms(prefetch_time),
+			to_ms(stage_times[GLS_LABELSCAN]), to_ms(stage_times[GLS_INIT]), to_ms(stage_times[GLS_RESERVE]), to_ms(stage_times[GLS_ACTIVATION]),
+			to_ms(end_time - after_load_start_time));
 
 	/* Now revert back to the original situation */
 	_cur_year     = year;
@@ -53,6 +53,10 @@ struct AnimationBase {
 		 * increasing this value by one doubles the wait. 0 is the minimum value
 		 * allowed for animation_speed, which corresponds to 30ms, and 16 is the
 		 * maximum, corresponding to around 33 minutes. */
+		if (!HasBit(spec->callback_mask, Tbase::cbm_animation_speed)) {
+			/* The speed is fixed, so nothing needs to be done for this tile until the next multiple of the animation speed. */
+			ScheduleAnimatedTile(tile, animation_speed);
+		}
 		if (_scaled_tick_counter % (1 << animation_speed) != 0) return;
 
 		uint8 frame      = GetAnimationFrame(tile);
@@ -27,7 +27,19 @@
 #include "fios.h"
 
 #include "thread.h"
+#include "rev.h"
+#include <chrono>
+#include <map>
+#include <memory>
 #include <mutex>
+#include <string>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#include "os/windows/win32.h"
+#else
+#include <unistd.h>
+#endif /* _WIN32 */
 #include <condition_variable>
 #if defined(__MINGW32__)
 #include "3rdparty/mingw-std-threads/mingw.mutex.h"
@@ -667,14 +679,347 @@ compatible_grf:
 	return res;
 }
 
+char *_newgrf_scan_cache_file; ///< The file to store the details of scanned NewGRFs in.
+
+/**
+ * Get the size and modification time of a file, to find out whether it changed since it was last scanned.
+ * @param filename The file.
+ * @param[out] size The size of the file.
+ * @param[out] mtime The modification time of the file.
+ * @return Whether the size and modification time are known.
+ */
+static bool GetNewGRFFileStat(const char *filename, uint64 &size, uint64 &mtime)
+{
+#ifdef _WIN32
+	HANDLE fh = CreateFile(OTTD2FS(filename), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, 0, nullptr);
+	if (fh == INVALID_HANDLE_VALUE) return false;
+
+	FILETIME ft;
+	LARGE_INTEGER fs;
+	bool ok = GetFileTime(fh, nullptr, nullptr, &ft) != 0 && GetFileSizeEx(fh, &fs) != 0;
+	CloseHandle(fh);
+	if (!ok) return false;
+
+	size = fs.QuadPart;
+	mtime = ((uint64)ft.dwHighDateTime << 32) | ft.dwLowDateTime;
+	return true;
+#else
+	struct stat sb;
+	if (stat(filename, &sb) != 0) return false;
+
+	size = sb.st_size;
+	mtime = sb.st_mtime;
+	return true;
+#endif
+}
+
+/**
+ * Details of scanned NewGRF files, stored on disk so files which did not change do not have to be read again by the next scan.
+ * Files are identified by their path; their details are invalidated when their size or modification time changes.
+ * All details are invalidated when the revision of OpenTTD changes, as it may handle the NewGRFs differently.
+ */
+struct NewGRFScanCache {
+	/** Details of a scanned file. */
+	struct Entry {
+		uint64 size;                       ///< Size of the file when it was scanned.
+		uint64 mtime;                      ///< Modification time of the file when it was scanned.
+		std::unique_ptr<GRFConfig> config; ///< The details of the NewGRF, or \c nullptr if the file is not a usable NewGRF.
+	};
+
+	std::map<std::string, Entry> entries; ///< Scanned files by their path.
+
+	static const uint32 MAGIC = 'GRFS';   ///< Identifier of a scan cache file.
+	static const uint32 VERSION = 1;      ///< Version of the format of a scan cache file.
+
+	const Entry *Find(const std::string &path, uint64 size, uint64 mtime) const;
+	void Add(const std::string &path, uint64 size, uint64 mtime, const GRFConfig *config);
+	void Load();
+	void Save() const;
+};
+
+/**
+ * Find the details of a file which did not change since it was scanned.
+ * @param path Path of the file.
+ * @param size Current size of the file.
+ * @param mtime Current modification time of the file.
+ * @return The details of the file, or \c nullptr if they are not known or outdated.
+ */
+const NewGRFScanCache::Entry *NewGRFScanCache::Find(const std::string &path, uint64 size, uint64 mtime) const
+{
+	auto it = this->entries.find(path);
+	if (it == this->entries.end() || it->second.size != size || it->second.mtime != mtime) return nullptr;
+	return &it->second;
+}
+
+/**
+ * Add the details of a scanned file.
+ * @param path Path of the file.
+ * @param size Size of the file.
+ * @param mtime Modification time of the file.
+ * @param config The details of the NewGRF to copy, or \c nullptr if the file is not a usable NewGRF.
+ */
+void NewGRFScanCache::Add(const std::string &path, uint64 size, uint64 mtime, const GRFConfig *config)
+{
+	Entry &entry = this->entries[path];
+	entry.size = size;
+	entry.mtime = mtime;
+	entry.config.reset(config == nullptr ? nullptr : new GRFConfig(*config));
+}
+
+/** Writer for the scan cache file; failures are only checked at the end. */
+struct NewGRFScanCacheWriter {
+	FILE *f;
+
+	void Byte(byte value) { fputc(value, this->f); }
+	void Dword(uint32 value) { for (uint i = 0; i < 4; i++) this->Byte(GB(value, i * 8, 8)); }
+	void Qword(uint64 value) { this->Dword((uint32)value); this->Dword((uint32)(value >> 32)); }
+
+	void String(const std::string &str)
+	{
+		this->Dword((uint32)str.size());
+		fwrite(str.data(), 1, str.size(), this->f);
+	}
+
+	void TextList(const GRFTextList *list)
+	{
+		this->Dword(list == nullptr ? 0 : (uint32)list->size());
+		if (list == nullptr) return;
+		for (const GRFText &text : *list) {
+			this->Byte(text.langid);
+			this->String(text.text);
+		}
+	}
+};
+
+/** Reader for the scan cache file; reads past the end or of invalid data mark the reader as failed. */
+struct NewGRFScanCacheReader {
+	FILE *f;
+	bool failed;
+
+	byte Byte()
+	{
+		int value = fgetc(this->f);
+		if (value == EOF) {
+			this->failed = true;
+			return 0;
+		}
+		return value;
+	}
+
+	uint32 Dword() { uint32 value = 0; for (uint i = 0; i < 4; i++) value |= (uint32)this->Byte() << (i * 8); return value; }
+	uint64 Qword() { uint64 value = this->Dword(); return value | ((uint64)this->Dword() << 32); }
+
+	std::string String()
+	{
+		uint32 length = this->Dword();
+		if (this->failed || length > (1 << 20)) {
+			this->failed = true;
+			return std::string();
+		}
+		std::string str(length, '\0');
+		if (length != 0 && fread(&str[0], 1, length, this->f) != length) this->failed = true;
+		return str;
+	}
+
+	void TextList(GRFTextList &list)
+	{
+		uint32 count = this->Dword();
+		for (uint32 i = 0; i < count && !this->failed; i++) {
+			byte langid = this->Byte();
+			list.push_back({ langid, this->String() });
+		}
+	}
+
+	void TextList(GRFTextWrapper &wrapper)
+	{
+		GRFTextList list;
+		this->TextList(list);
+		if (!list.empty()) wrapper = std::make_shared<GRFTextList>(std::move(list));
+	}
+};
+
+/**
+ * Load the details of previously scanned files from #_newgrf_scan_cache_file.
+ * If the file is missing, from another revision or damaged, nothing is loaded.
+ */
+void NewGRFScanCache::Load()
+{
+	this->entries.clear();
+	if (_newgrf_scan_cache_file == nullptr) return;
+
+	FILE *f = fopen(_newgrf_scan_cache_file, "rb");
+	if (f == nullptr) return;
+
+	NewGRFScanCacheReader reader = { f, false };
+	if (reader.Dword() != MAGIC || reader.Dword() != VERSION || reader.String() != _openttd_revision) {
+		DEBUG(grf, 1, "NewGRF scan cache is outdated, rescanning all NewGRFs");
+		fclose(f);
+		return;
+	}
+
+	for (uint32 count = reader.Dword(); count > 0 && !reader.failed; count--) {
+		std::string path = reader.String();
+		Entry &entry = this->entries[path];
+		entry.size = reader.Qword();
+		entry.mtime = reader.Qword();
+		if (reader.Byte() == 0) continue;
+
+		GRFConfig *c = new GRFConfig(reader.String().c_str());
+		entry.config.reset(c);
+		c->ident.grfid = reader.Dword();
+		for (uint i = 0; i < lengthof(c->ident.md5sum); i++) c->ident.md5sum[i] = reader.Byte();
+		reader.TextList(c->name);
+		reader.TextList(c->info);
+		reader.TextList(c->url);
+		c->version = reader.Dword();
+		c->min_loadable_version = reader.Dword();
+		c->flags = reader.Byte();
+		c->palette = reader.Byte();
+		c->num_params = min<uint>(reader.Byte(), lengthof(c->param));
+		for (uint i = 0; i < c->num_params; i++) c->param[i] = reader.Dword();
+		c->num_valid_params = reader.Byte();
+		c->has_param_defaults = reader.Byte() != 0;
+
+		for (uint32 num_info = reader.Dword(); num_info > 0 && !reader.failed; num_info--) {
+			if (reader.Byte() == 0) {
+				c->param_info.push_back(nullptr);
+				continue;
+			}
+			GRFParameterInfo *info = new GRFParameterInfo(0);
+			c->param_info.push_back(info);
+			reader.TextList(info->name);
+			reader.TextList(info->desc);
+			info->type = (GRFParameterType)min<byte>(reader.Byte(), PTYPE_END);
+			info->min_value = reader.Dword();
+			info->max_value = reader.Dword();
+			info->def_value = reader.Dword();
+			info->param_nr = reader.Byte();
+			info->first_bit = reader.Byte();
+			info->num_bit = reader.Byte();
+			for (uint32 num_names = reader.Dword(); num_names > 0 && !reader.failed; num_names--) {
+				uint32 value = reader.Dword();
+				reader.TextList(info->value_names[value]);
+			}
+			info->complete_labels = reader.Byte() != 0;
+		}
+	}
+	fclose(f);
+
+	if (reader.failed) {
+		DEBUG(grf, 0, "NewGRF scan cache '%s' is damaged, rescanning all NewGRFs", _newgrf_scan_cache_file);
+		this->entries.clear();
+	}
+}
+
+/**
+ * Save the details of the scanned files to #_newgrf_scan_cache_file.
+ * The cache is written to a temporary file first, which then replaces the cache file, so that a crash
+ * or another instance saving at the same time cannot leave a truncated or mixed cache file behind.
+ */
+void NewGRFScanCache::Save() const
+{
+	if (_newgrf_scan_cache_file == nullptr) return;
+
+	/* The name of the temporary file is unique per save, as other instances may be saving too. */
+	std::string file_new = _newgrf_scan_cache_file;
+	file_new += stdstr_fmt(".%08X.new", (uint32)std::chrono::high_resolution_clock::now().time_since_epoch().count());
+
+	FILE *f = fopen(file_new.c_str(), "wb");
+	if (f == nullptr) {
+		DEBUG(grf, 0, "Could not write NewGRF scan cache '%s'", _newgrf_scan_cache_file);
+		return;
+	}
+
+	NewGRFScanCacheWriter writer = { f };
+	writer.Dword(MAGIC);
+	writer.Dword(VERSION);
+	writer.String(_openttd_revision);
+	writer.Dword((uint32)this->entries.size());
+	for (const auto &it : this->entries) {
+		const Entry &entry = it.second;
+		const GRFConfig *c = entry.config.get();
+		writer.String(it.first);
+		writer.Qword(entry.size);
+		writer.Qword(entry.mtime);
+		writer.Byte(c != nullptr ? 1 : 0);
+		if (c == nullptr) continue;
+
+		writer.String(c->filename);
+		writer.Dword(c->ident.grfid);
+		for (uint i = 0; i < lengthof(c->ident.md5sum); i++) writer.Byte(c->ident.md5sum[i]);
+		writer.TextList(c->name.get());
+		writer.TextList(c->info.get());
+		writer.TextList(c->url.get());
+		writer.Dword(c->version);
+		writer.Dword(c->min_loadable_version);
+		writer.Byte(c->flags);
+		writer.Byte(c->palette);
+		writer.Byte(c->num_params);
+		for (uint i = 0; i < c->num_params; i++) writer.Dword(c->param[i]);
+		writer.Byte(c->num_valid_params);
+		writer.Byte(c->has_param_defaults ? 1 : 0);
+
+		writer.Dword((uint32)c->param_info.size());
+		for (const GRFParameterInfo *info : c->param_info) {
+			writer.Byte(info != nullptr ? 1 : 0);
+			if (info == nullptr) continue;
+			writer.TextList(&info->name);
+			writer.TextList(&info->desc);
+			writer.Byte(info->type);
+			writer.Dword(info->min_value);
+			writer.Dword(info->max_value);
+			writer.Dword(info->def_value);
+			writer.Byte(info->param_nr);
+			writer.Byte(info->first_bit);
+			writer.Byte(info->num_bit);
+			writer.Dword((uint32)info->value_names.size());
+			for (const auto &name : info->value_names) {
+				writer.Dword(name.first);
+				writer.TextList(&name.second);
+			}
+			writer.Byte(info->complete_labels ? 1 : 0);
+		}
+	}
+
+	bool failed = ferror(f) != 0;
+	if (fclose(f) != 0 || failed) {
+		DEBUG(grf, 0, "Could not write NewGRF scan cache '%s'", _newgrf_scan_cache_file);
+		unlink(file_new.c_str());
+		return;
+	}
+
+#if defined(_WIN32)
+	/* rename does not replace existing files on Windows. */
+	TCHAR tfile_new[MAX_PATH], tfilename[MAX_PATH];
+	bool replaced = MoveFileEx(convert_to_fs(file_new.c_str(), tfile_new, lengthof(tfile_new)), convert_to_fs(_newgrf_scan_cache_file, tfilename, lengthof(tfilename)), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+	bool replaced = rename(file_new.c_str(), _newgrf_scan_cache_file) == 0;
+#endif
+	if (!replaced) {
+		DEBUG(grf, 0, "Could not write NewGRF scan cache '%s'", _newgrf_scan_cache_file);
+		unlink(file_new.c_str());
+	}
+}
+
 /** Helper for scanning for files with GRF as extension */
 class GRFFileScanner : FileScanner {
+	/** A file found by the scan, to add to the scan cache once the MD5 sums are calculated. */
+	struct ScannedFile {
+		std::string path;  ///< Path of the file.
+		uint64 size;       ///< Size of the file.
+		uint64 mtime;      ///< Modification time of the file.
+		GRFConfig *config; ///< The details of the NewGRF, or \c nullptr if the file is not a usable NewGRF.
+	};
+
 	uint next_update; ///< The next (realtime tick) we do update the screen.
 	uint num_scanned; ///< The number of GRFs we have scanned.
+	uint num_cached;  ///< The number of GRFs of which the details were taken from the scan cache.
 	std::vector<GRFConfig *> grfs;
+	NewGRFScanCache cache;               ///< Details of the files found by the previous scan.
+	std::vector<ScannedFile> scanned;    ///< Files found by this scan.
 
 public:
-	GRFFileScanner() : num_scanned(0)
+	GRFFileScanner() : num_scanned(0), num_cached(0)
 	{
 #if defined(__GNUC__) || defined(__clang__)
 		this->next_update = __atomic_load_n(&_realtime_tick, __ATOMIC_RELAXED);
@@ -688,12 +1033,22 @@ public:
 	/** Do the scan for GRFs. */
 	static uint DoScan()
 	{
-		CalcGRFMD5ThreadingStart();
 		GRFFileScanner fs;
+		fs.cache.Load();
+
+		CalcGRFMD5ThreadingStart();
 		fs.grfs.clear();
 		int ret = fs.Scan(".grf", NEWGRF_DIR);
 		CalcGRFMD5ThreadingEnd();
 
+		/* Now all MD5 sums are known, replace the scan cache by the details of the files found by this scan. */
+		fs.cache.entries.clear();
+		for (const ScannedFile &file : fs.scanned) {
+			fs.cache.Add(file.path, file.size, file.mtime, file.config);
+		}
+		fs.cache.Save();
+		DEBUG(grf, 1, "Took the details of %u of %u NewGRF files from the scan cache", fs.num_cached, fs.num_scanned);
+
 		for (GRFConfig *c : fs.grfs) {
 			bool added = true;
 			if (_all_grfs == nullptr) {
@@ -733,11 +1088,32 @@ public:
 
 bool GRFFileScanner::AddFile(const char *filename, size_t basepath_length, const char *tar_filename)
 {
-	GRFConfig *c = new GRFConfig(filename + basepath_length);
+	/* Files in tars are identified by the tar and their name in it, and change with the tar. */
+	std::string path = tar_filename != nullptr ? std::string(tar_filename) + PATHSEP + filename : std::string(filename);
+	uint64 size, mtime;
+	bool have_stat = GetNewGRFFileStat(tar_filename != nullptr ? tar_filename : filename, size, mtime);
+
+	const NewGRFScanCache::Entry *cached = have_stat ? this->cache.Find(path, size, mtime) : nullptr;
+	if (cached != nullptr && cached->config != nullptr && strcmp(cached->config->filename, filename + basepath_length) != 0) cached = nullptr;
+
+	GRFConfig *c;
+	bool added;
+	if (cached != nullptr) {
+		c = cached->config != nullptr ? new GRFConfig(*cached->config) : new GRFConfig(filename + basepath_length);
+		added = cached->config != nullptr;
+		if (added) c->SetSuitablePalette();
+		this->num_cached++;
+	} else {
+		c = new GRFConfig(filename + basepath_length);
+		added = FillGRFDetails(c, false);
+	}
 
-	bool added = FillGRFDetails(c, false);
 	if (added) {
 		this->grfs.push_back(c);
+		if (have_stat) this->scanned.push_back({ path, size, mtime, c });
+	} else if (have_stat && c->status != GCS_NOT_FOUND && (c->ident.grfid == 0 || HasBit(c->flags, GCF_SYSTEM))) {
+		/* Not a usable NewGRF; remember that, unless the file could just not be read. */
+		this->scanned.push_back({ path, size, mtime, nullptr });
 	}
 
 	this->num_scanned++;
@@ -24,6 +24,7 @@
 #include "industry.h"
 #include "object_base.h"
 #include "station_base.h"
+#include "station_func.h"
 #include "town.h"
 #include "vehicle_base.h"
 #include "train.h"
@@ -77,9 +77,11 @@
 #include "industry.h"
 #include "cargopacket.h"
 #include "core/checksum_func.hpp"
+#include "spritecache.h"
 
 #include "linkgraph/linkgraphschedule.h"
 #include "tracerestrict.h"
+#include "pathfinder/yapf/yapf.h"
 
 #include <stdarg.h>
 #include <system_error>
@@ -412,6 +414,7 @@ static void ShutdownGame()
 	ClearTraceRestrictMapping();
 	ClearBridgeSimulatedSignalMapping();
 	ClearCargoPacketDeferredPayments();
+	YapfStopPathPrefetchers();
 	PoolBase::Clean(PT_ALL);
 
 	FreeSignalPrograms();
@@ -424,6 +427,7 @@ static void ShutdownGame()
 	if (_game_mode != GM_BOOTSTRAP) ResetNewGRFData();
 
 	/* Close all and any open filehandles */
+	StopAsyncSpriteLoaders();
 	FioCloseAll();
 
 	UninitFreeType();
@@ -1365,6 +1369,12 @@ void CheckCaches(bool force_check, std::function<void(const char *)> log)
 	} \
 }
 
+	extern uint ValidateRailFollowCache();
+	uint rail_follow_cache_errors = ValidateRailFollowCache();
+	if (rail_follow_cache_errors != 0) {
+		CCLOG("rail follow cache mismatch: %u entries", rail_follow_cache_errors);
+	}
+
 	/* Check the town caches. */
 	std::vector<TownCache> old_town_caches;
 	std::vector<CargoTypes> old_town_cargo_accepted_totals;
@@ -1490,6 +1500,11 @@ void CheckCaches(bool force_check, std::function<void(const char *)> log)
 		rs->GetEntry(DIAGDIR_NW)->CheckIntegrity(rs);
 	}
 
+	extern bool ValidateTrainTileHashOccupancy();
+	if (!ValidateTrainTileHashOccupancy()) {
+		CCLOG("train tile hash occupancy mismatch");
+	}
+
 	for (Vehicle *v : Vehicle::Iterate()) {
 		extern bool ValidateVehicleTileHash(const Vehicle *v);
 		if (!ValidateVehicleTileHash(v)) {
@@ -1500,10 +1515,18 @@ void CheckCaches(bool force_check, std::function<void(const char *)> log)
 		if (v != v->First() || v->vehstatus & VS_CRASHED || !v->IsPrimaryVehicle()) continue;
 
 		uint length = 0;
+		int64 slope_resistance = 0;
 		for (const Vehicle *u = v; u != nullptr; u = u->Next()) {
 			if (u->IsGroundVehicle() && (HasBit(u->GetGroundVehicleFlags(), GVF_GOINGUP_BIT) || HasBit(u->GetGroundVehicleFlags(), GVF_GOINGDOWN_BIT)) && u->GetGroundVehicleCache()->cached_slope_resistance && HasBit(v->vcache.cached_veh_flags, VCF_GV_ZERO_SLOPE_RESIST)) {
 				CCLOGV("VCF_GV_ZERO_SLOPE_RESIST set incorrectly (1)");
 			}
+			if (u->IsGroundVehicle()) {
+				if (HasBit(u->GetGroundVehicleFlags(), GVF_GOINGUP_BIT)) {
+					slope_resistance += u->GetGroundVehicleCache()->cached_slope_resistance;
+				} else if (HasBit(u->GetGroundVehicleFlags(), GVF_GOINGDOWN_BIT)) {
+					slope_resistance -= u->GetGroundVehicleCache()->cached_slope_resistance;
+				}
+			}
 			if (u->type == VEH_TRAIN && u->breakdown_ctr != 0 && !HasBit(Train::From(v)->flags, VRF_CONSIST_BREAKDOWN)) {
 				CCLOGV("VRF_CONSIST_BREAKDOWN incorrectly not set");
 			}
@@ -1512,6 +1535,18 @@ void CheckCaches(bool force_check, std::function<void(const char *)> log)
 			}
 			length++;
 		}
+		if (HasBit(v->vcache.cached_veh_flags, VCF_GV_SLOPE_RESIST_VALID)) {
+			int64 cached_slope_resistance = 0;
+			switch (v->type) {
+				case VEH_TRAIN: cached_slope_resistance = Train::From(v)->cached_total_slope_resistance; break;
+				case VEH_ROAD:  cached_slope_resistance = RoadVehicle::From(v)->cached_total_slope_resistance; break;
+				default: break;
+			}
+			if (cached_slope_resistance != slope_resistance) {
+				CCLOG("cached total slope resistance mismatch: type %i, vehicle %i, company %i, unit number %i, cached: " OTTD_PRINTF64 ", actual: " OTTD_PRINTF64,
+						(int)v->type, v->index, (int)v->owner, v->unitnumber, cached_slope_resistance, slope_resistance);
+			}
+		}
 
 		NewGRFCache        *grf_cache = CallocT<NewGRFCache>(length);
 		VehicleCache       *veh_cache = CallocT<VehicleCache>(length);
@@ -1694,6 +1729,7 @@ void CheckCaches(bool force_check, std::function<void(const char *)> log)
 
 	if (!TraceRestrictSlot::ValidateVehicleIndex()) CCLOG("Trace restrict slot vehicle index validation failed");
 	TraceRestrictSlot::ValidateSlotOccupants(log);
+	TraceRestrictProgram::ValidateCompiledPrograms(log);
 
 	if (!CargoPacket::ValidateDeferredCargoPayments()) CCLOG("Cargo packets deferred payments validation failed");
 
@@ -1741,6 +1777,8 @@ CommandCost CmdDesyncCheck(TileIndex tile, DoCommandFlag flags, uint32 p1, uint3
  */
 void StateGameLoop()
 {
+	YapfFinishPathPrefetches();
+
 	if (!_networking || _network_server) {
 		extern void StateGameLoop_LinkGraphPauseControl();
 		StateGameLoop_LinkGraphPauseControl();
@@ -1767,8 +1805,6 @@ void StateGameLoop()
 	PerformanceAccumulator::Reset(PFE_GL_LANDSCAPE);
 	if (HasModalProgress()) return;
 
-	Layouter::ReduceLineCache();
-
 	if (_game_mode == GM_EDITOR) {
 		BasePersistentStorageArray::SwitchMode(PSM_ENTER_GAMELOOP);
 		RunTileLoop();
@@ -1823,6 +1859,8 @@ void StateGameLoop()
 		NewsLoop();
 		cur_company.Restore();
 
+		YapfStartPathPrefetches();
+
 		for (Company *c : Company::Iterate()) {
 			UpdateStateChecksum(c->money);
 		}
@@ -1900,6 +1938,9 @@ void GameLoop()
 		StateGameLoop();
 	}
 
+	/* Also done while paused, when text may still be laid out by the GUI. */
+	if (!HasModalProgress()) Layouter::ReduceLineCache();
+
 	InputLoop();
 
 	SoundDriver::GetInstance()->MainLoop();
@@ -37,6 +37,7 @@
 #include "order_cmd.h"
 #include "vehiclelist.h"
 #include "tracerestrict.h"
+#include "departures_func.h"
 
 #include "table/strings.h"
 
@@ -328,6 +329,7 @@ Order::Order(uint32 packed)
 void InvalidateVehicleOrder(const Vehicle *v, int data)
 {
 	SetWindowDirty(WC_VEHICLE_VIEW, v->index);
+	InvalidateDepartureLists();
 
 	if (data != 0) {
 		/* Calls SetDirty() too */
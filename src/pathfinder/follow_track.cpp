@@ -0,0 +1,63 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file follow_track.cpp Cache of the results of rail track followers. */
+
+#include "../stdafx.h"
+#include "follow_track.hpp"
+
+#include "../safeguards.h"
+
+RailFollowCacheEntry _rail_follow_cache[1 << RAIL_FOLLOW_CACHE_BITS];
+
+/** Current track layout generation, entries of the rail follow cache with another generation are invalid. */
+uint32 _rail_follow_cache_generation = 1;
+
+/**
+ * Invalidate all entries of the rail follow cache.
+ * Must be called whenever the track layout, or anything else a rail track follower depends on, changes.
+ */
+void InvalidateRailFollowCache()
+{
+	_rail_follow_cache_generation++;
+	if (_rail_follow_cache_generation == 0) {
+		/* Make sure entries from before the wrap around can not become valid again. */
+		memset(_rail_follow_cache, 0, sizeof(_rail_follow_cache));
+		_rail_follow_cache_generation = 1;
+	}
+}
+
+/**
+ * Check whether a valid entry of the rail follow cache matches the result of following the track again.
+ * @param entry The cache entry.
+ * @return True if the entry is correct.
+ */
+template <class Follower>
+static bool ValidateRailFollowCacheEntry(const RailFollowCacheEntry &entry)
+{
+	Follower ft(entry.owner, entry.railtypes);
+	bool result = ft.FollowUncached(entry.old_tile, entry.old_td);
+	return result == entry.result && ft.m_new_tile == entry.new_tile && ft.m_new_td_bits == entry.new_td_bits &&
+			ft.m_exitdir == entry.exitdir && ft.m_err == entry.err && ft.m_is_tunnel == entry.is_tunnel &&
+			ft.m_is_bridge == entry.is_bridge && ft.m_is_station == entry.is_station && ft.m_tiles_skipped == entry.tiles_skipped;
+}
+
+/**
+ * Check whether all valid entries of the rail follow cache match the result of following the track again.
+ * @return The number of incorrect entries.
+ */
+uint ValidateRailFollowCache()
+{
+	uint errors = 0;
+	for (const RailFollowCacheEntry &entry : _rail_follow_cache) {
+		if (entry.generation != _rail_follow_cache_generation) continue;
+
+		bool ok = HasBit(entry.flags, RFCF_NO_90DEG) ? ValidateRailFollowCacheEntry<CFollowTrackRailNo90>(entry) : ValidateRailFollowCacheEntry<CFollowTrackRail>(entry);
+		if (!ok) errors++;
+	}
+	return errors;
+}
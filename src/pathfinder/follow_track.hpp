@@ -20,6 +20,52 @@
 #include "../infrastructure_func.h"
 #include "pf_performance_timer.hpp"
 
+/** Flags of a #RailFollowCacheEntry. */
+enum RailFollowCacheFlags {
+	RFCF_NO_90DEG = 0, ///< The entry is for a track follower which does not allow 90 degree turns.
+};
+
+/**
+ * Cached result of following rail track from a tile and trackdir.
+ * Rail track followers with the same key share the entry, see CFollowTrackT::Follow.
+ */
+struct RailFollowCacheEntry {
+	uint32 generation;         ///< Track layout generation the entry is valid for, see #_rail_follow_cache_generation.
+	TileIndex old_tile;        ///< Key: tile followed from.
+	Trackdir old_td;           ///< Key: trackdir followed from.
+	Owner owner;               ///< Key: owner of the vehicle.
+	uint8 flags;               ///< Key: #RailFollowCacheFlags.
+	RailTypes railtypes;       ///< Key: rail types the vehicle can use.
+	TileIndex new_tile;        ///< Result: the new tile.
+	TrackdirBits new_td_bits;  ///< Result: the new set of available trackdirs.
+	DiagDirection exitdir;     ///< Result: the exit direction.
+	uint8 err;                 ///< Result: the error code.
+	bool is_tunnel;            ///< Result: a tunnel was passed.
+	bool is_bridge;            ///< Result: a bridge ramp was passed.
+	bool is_station;           ///< Result: a station was passed.
+	bool result;               ///< Result: whether the track could be followed.
+	int tiles_skipped;         ///< Result: number of skipped tunnel, bridge or station tiles.
+};
+
+static const uint RAIL_FOLLOW_CACHE_BITS = 12; ///< Log2 of the number of entries of the rail follow cache.
+
+extern RailFollowCacheEntry _rail_follow_cache[1 << RAIL_FOLLOW_CACHE_BITS];
+extern uint32 _rail_follow_cache_generation;
+
+void InvalidateRailFollowCache();
+
+/**
+ * Get the rail follow cache entry which a follow from a tile and trackdir uses.
+ * @param tile The tile followed from.
+ * @param td The trackdir followed from.
+ * @return The cache entry.
+ */
+static inline RailFollowCacheEntry &GetRailFollowCacheEntry(TileIndex tile, Trackdir td)
+{
+	uint32 hash = ((tile << 4) | td) * 0x9E3779B1u;
+	return _rail_follow_cache[hash >> (32 - RAIL_FOLLOW_CACHE_BITS)];
+}
+
 /**
  * Track follower helper template class (can serve pathfinders and vehicle
  *  controllers). See 6 different typedefs below for 3 different transport
@@ -119,8 +165,55 @@ struct CFollowTrackT
 	/**
 	 * main follower routine. Fills all members and return true on success.
 	 *  Otherwise returns false if track can't be followed.
+	 * For rail, the result is looked up in the rail follow cache first, which is shared by all rail track followers
+	 *  and invalidated whenever the track layout changes. #MaskReservedTracks is not cached.
 	 */
 	inline bool Follow(TileIndex old_tile, Trackdir old_td)
+	{
+		if (!IsRailTT()) return FollowUncached(old_tile, old_td);
+
+		RailFollowCacheEntry &entry = GetRailFollowCacheEntry(old_tile, old_td);
+		const uint8 flags = Allow90degTurns() ? 0 : (1 << RFCF_NO_90DEG);
+		if (entry.generation == _rail_follow_cache_generation && entry.old_tile == old_tile && entry.old_td == old_td &&
+				entry.owner == m_veh_owner && entry.flags == flags && entry.railtypes == m_railtypes) {
+			m_old_tile = old_tile;
+			m_old_td = old_td;
+			m_new_tile = entry.new_tile;
+			m_new_td_bits = entry.new_td_bits;
+			m_exitdir = entry.exitdir;
+			m_err = (ErrorCode)entry.err;
+			m_is_tunnel = entry.is_tunnel;
+			m_is_bridge = entry.is_bridge;
+			m_is_station = entry.is_station;
+			m_tiles_skipped = entry.tiles_skipped;
+			return entry.result;
+		}
+
+		bool result = FollowUncached(old_tile, old_td);
+
+		entry.generation = _rail_follow_cache_generation;
+		entry.old_tile = old_tile;
+		entry.old_td = old_td;
+		entry.owner = m_veh_owner;
+		entry.flags = flags;
+		entry.railtypes = m_railtypes;
+		entry.new_tile = m_new_tile;
+		entry.new_td_bits = m_new_td_bits;
+		entry.exitdir = m_exitdir;
+		entry.err = m_err;
+		entry.is_tunnel = m_is_tunnel;
+		entry.is_bridge = m_is_bridge;
+		entry.is_station = m_is_station;
+		entry.tiles_skipped = m_tiles_skipped;
+		entry.result = result;
+		return result;
+	}
+
+	/**
+	 * Follower routine without using the rail follow cache.
+	 * @see Follow
+	 */
+	inline bool FollowUncached(TileIndex old_tile, Trackdir old_td)
 	{
 		m_old_tile = old_tile;
 		m_old_td = old_td;
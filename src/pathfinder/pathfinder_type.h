@@ -41,9 +41,15 @@ static const int YAPF_INFINITE_PENALTY = 1000 * YAPF_TILE_LENGTH;
 /** Maximum length of ship path cache */
 static const int YAPF_SHIP_PATH_CACHE_LENGTH = 32;
 
+/** Remaining length of ship path cache at which the path beyond it is prefetched */
+static const int YAPF_SHIP_PATH_CACHE_PREFETCH = 8;
+
 /** Maximum segments of road vehicle path cache */
 static const int YAPF_ROADVEH_PATH_CACHE_SEGMENTS = 16;
 
+/** Remaining segments of road vehicle path cache at which the choices beyond it are prefetched */
+static const int YAPF_ROADVEH_PATH_CACHE_PREFETCH = 2;
+
 /** Distance from destination road stops to not cache any further */
 static const int YAPF_ROADVEH_PATH_CACHE_DESTINATION_LIMIT = 8;
 
@@ -14,31 +14,160 @@
 #include "../../misc/hashtable.hpp"
 #include "../../misc/binaryheap.hpp"
 
+#include <memory>
+#include <vector>
+
+/**
+ * Array of nodes which keeps its memory when it is reset, so it can be reused by many searches.
+ *  Nodes are allocated in blocks, so they never move.
+ */
+template <class Titem_, uint Tblock_size_ = 4096>
+class CNodeArenaT {
+protected:
+	std::vector<Titem_ *> blocks; ///< Allocated blocks of nodes.
+	uint items;                   ///< Number of constructed nodes.
+
+public:
+	CNodeArenaT() : items(0) {}
+
+	~CNodeArenaT()
+	{
+		this->Reset();
+		for (Titem_ *block : this->blocks) free(block);
+	}
+
+	/** Destroy all nodes, but keep the memory for reuse. */
+	inline void Reset()
+	{
+		for (uint i = 0; i < this->items; i++) (*this)[i].~Titem_();
+		this->items = 0;
+	}
+
+	/** Return actual number of nodes. */
+	inline uint Length() const
+	{
+		return this->items;
+	}
+
+	/** Allocate and construct a new node. */
+	inline Titem_ *AppendC()
+	{
+		if (this->items == this->blocks.size() * Tblock_size_) this->blocks.push_back(MallocT<Titem_>(Tblock_size_));
+		Titem_ *item = &this->blocks[this->items / Tblock_size_][this->items % Tblock_size_];
+		this->items++;
+		new (item) Titem_();
+		return item;
+	}
+
+	/** Indexed access (non-const). */
+	inline Titem_ &operator[](uint index)
+	{
+		assert(index < this->items);
+		return this->blocks[index / Tblock_size_][index % Tblock_size_];
+	}
+
+	/** Indexed access (const). */
+	inline const Titem_ &operator[](uint index) const
+	{
+		assert(index < this->items);
+		return this->blocks[index / Tblock_size_][index % Tblock_size_];
+	}
+
+	/**
+	 * Helper for creating a human readable output of this data.
+	 * @param dmp The location to dump to.
+	 */
+	template <typename D> void Dump(D &dmp) const
+	{
+		dmp.WriteLine("num_items = %d", this->items);
+		CStrA name;
+		for (uint i = 0; i < this->items; i++) {
+			name.Format("item[%d]", i);
+			dmp.WriteStructT(name.Data(), &(*this)[i]);
+		}
+	}
+};
+
 /**
  * Hash table based node list multi-container class.
  *  Implements open list, closed list and priority queue for A-star
  *  path finder.
+ *
+ *  The containers are kept per thread after a search, and reused by the next
+ *  search with the same node list type, so searches do not have to allocate
+ *  and clear them. Resetting them only touches the nodes of the previous search.
  */
 template <class Titem_, int Thash_bits_open_, int Thash_bits_closed_>
 class CNodeList_HashTableT {
 public:
 	typedef Titem_ Titem;                                        ///< Make #Titem_ visible from outside of class.
 	typedef typename Titem_::Key Key;                            ///< Make Titem_::Key a property of this class.
-	typedef SmallArray<Titem_, 65536, 256> CItemArray;           ///< Type that we will use as item container.
+	typedef CNodeArenaT<Titem_> CItemArray;                      ///< Type that we will use as item container.
 	typedef CHashTableT<Titem_, Thash_bits_open_  > COpenList;   ///< How pointers to open nodes will be stored.
 	typedef CHashTableT<Titem_, Thash_bits_closed_> CClosedList; ///< How pointers to closed nodes will be stored.
 	typedef CBinaryHeapT<Titem_> CPriorityQueue;                 ///< How the priority queue will be managed.
 
 protected:
-	CItemArray      m_arr;        ///< Here we store full item data (Titem_).
-	COpenList       m_open;       ///< Hash table of pointers to open item data.
-	CClosedList     m_closed;     ///< Hash table of pointers to closed item data.
-	CPriorityQueue  m_open_queue; ///< Priority queue of pointers to open item data.
+	/** The containers of a node list, which are reused by later searches. */
+	struct Storage {
+		CItemArray      arr;
+		COpenList       open;
+		CClosedList     closed;
+		CPriorityQueue  open_queue;
+
+		Storage() : open_queue(2048) {}
+
+		void Reset()
+		{
+			arr.Reset();
+			open.Clear();
+			closed.Clear();
+			open_queue.Clear();
+		}
+	};
+
+	/** Maximum number of unused storages to keep per thread; more are only needed by nested searches. */
+	static const uint MAX_SPARE_STORAGE = 2;
+
+	/** Unused storages of the current thread. */
+	static std::vector<std::unique_ptr<Storage>> &GetSpareStorage()
+	{
+		static thread_local std::vector<std::unique_ptr<Storage>> spare;
+		return spare;
+	}
+
+	/** Get unused storage for a new search. */
+	static Storage *AcquireStorage()
+	{
+		std::vector<std::unique_ptr<Storage>> &spare = GetSpareStorage();
+		if (spare.empty()) return new Storage();
+		Storage *storage = spare.back().release();
+		spare.pop_back();
+		return storage;
+	}
+
+	/** Reset the storage of a finished search, and keep it for the next search. */
+	static void ReleaseStorage(Storage *storage)
+	{
+		std::vector<std::unique_ptr<Storage>> &spare = GetSpareStorage();
+		if (spare.size() >= MAX_SPARE_STORAGE) {
+			delete storage;
+			return;
+		}
+		storage->Reset();
+		spare.emplace_back(storage);
+	}
+
+	Storage        *m_storage;    ///< Containers of this search.
+	CItemArray     &m_arr;        ///< Here we store full item data (Titem_).
+	COpenList      &m_open;       ///< Hash table of pointers to open item data.
+	CClosedList    &m_closed;     ///< Hash table of pointers to closed item data.
+	CPriorityQueue &m_open_queue; ///< Priority queue of pointers to open item data.
 	Titem          *m_new_node;   ///< New open node under construction.
 
 public:
 	/** default constructor */
-	CNodeList_HashTableT() : m_open_queue(2048)
+	CNodeList_HashTableT() : m_storage(AcquireStorage()), m_arr(m_storage->arr), m_open(m_storage->open), m_closed(m_storage->closed), m_open_queue(m_storage->open_queue)
 	{
 		m_new_node = nullptr;
 	}
@@ -46,8 +175,12 @@ public:
 	/** destructor */
 	~CNodeList_HashTableT()
 	{
+		ReleaseStorage(m_storage);
 	}
 
+	CNodeList_HashTableT(const CNodeList_HashTableT &) = delete;
+	CNodeList_HashTableT &operator=(const CNodeList_HashTableT &) = delete;
+
 	/** return number of open nodes */
 	inline int OpenCount()
 	{
@@ -28,6 +28,18 @@
  */
 Track YapfShipChooseTrack(const Ship *v, TileIndex tile, DiagDirection enterdir, TrackBits tracks, bool &path_found, ShipPathCache &path_cache);
 
+/**
+ * Finds the path for a ship beyond the end of its path cache, for use by #YapfQueueShipPathPrefetch.
+ * This only reads the game state, so it may be called from any thread while the game state is not changed.
+ * @param v          the ship that needs to find a path
+ * @param tile       the tile the ship has just chosen a trackdir for from its path cache
+ * @param td         the trackdir chosen on \a tile
+ * @param current    the remaining path cache of the ship
+ * @param path_cache [out] the trackdirs to append to the path cache of the ship
+ * @return           whether a path has been found
+ */
+bool YapfShipPrefetchPath(const Ship *v, TileIndex tile, Trackdir td, const ShipPathCache &current, ShipPathCache &path_cache);
+
 /**
  * Returns true if it is better to reverse the ship before leaving depot using YAPF.
  * @param v the ship leaving the depot
@@ -46,6 +58,17 @@ bool YapfShipCheckReverse(const Ship *v);
  */
 Trackdir YapfRoadVehicleChooseTrack(const RoadVehicle *v, TileIndex tile, DiagDirection enterdir, TrackdirBits trackdirs, bool &path_found, RoadVehPathCache &path_cache);
 
+/**
+ * Finds the path choices of a road vehicle following the last choice in its path cache, for use by #YapfQueueRoadVehiclePathPrefetch.
+ * This only reads the game state, so it may be called from any thread while the game state is not changed.
+ * @param v          the RV that needs to find a path
+ * @param tile       the tile of the last choice in the path cache of the RV
+ * @param td         the trackdir chosen on \a tile
+ * @param path_cache [out] the choices to append to the path cache of the RV
+ * @return           whether a path has been found
+ */
+bool YapfRoadVehiclePrefetchPath(const RoadVehicle *v, TileIndex tile, Trackdir td, RoadVehPathCache &path_cache);
+
 /**
  * Finds the best path for given train using YAPF.
  * @param v        the train that needs to find a path
@@ -97,4 +120,11 @@ bool YapfTrainCheckReverse(const Train *v);
  */
 bool YapfTrainFindNearestSafeTile(const Train *v, TileIndex tile, Trackdir td, bool override_railtype);
 
+void YapfQueueRoadVehiclePathPrefetch(const RoadVehicle *v);
+void YapfQueueShipPathPrefetch(const Ship *v, TileIndex tile, Trackdir td);
+void YapfStartPathPrefetches();
+void YapfFinishPathPrefetches();
+void YapfFinishStartedPathPrefetches();
+void YapfStopPathPrefetchers();
+
 #endif /* YAPF_H */
@@ -74,6 +74,7 @@ public:
 
 public:
 	int                  m_num_steps;          ///< this is there for debugging purposes (hope it doesn't hurt)
+	bool                 m_prefetch;           ///< search runs on a path prefetch thread, so it must not record timing stats or print debug output
 
 public:
 	/** default constructor */
@@ -85,6 +86,7 @@ public:
 		, m_stats_cost_calcs(0)
 		, m_stats_cache_hits(0)
 		, m_num_steps(0)
+		, m_prefetch(false)
 	{
 	}
 
@@ -151,7 +153,7 @@ public:
 		bDestFound &= (m_pBestDestNode != nullptr);
 
 		perf.Stop();
-		if (_debug_yapf_level >= 2) {
+		if (_debug_yapf_level >= 2 && !m_prefetch) {
 			int t = perf.Get(1000000);
 			_total_pf_time_us += t;
 
@@ -14,6 +14,7 @@
 
 /**
  * Use this function to notify YAPF that track layout (or signal configuration) has change.
+ * This also invalidates the rail follow cache of the track followers.
  * @param tile  the tile that is changed
  * @param track what piece of track is changed
  */
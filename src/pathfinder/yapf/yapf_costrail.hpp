@@ -269,7 +269,11 @@ private:
 			flags_to_check |= TRPAUF_REVERSE;
 		}
 		if (prog && prog->actions_used_flags & flags_to_check) {
-			prog->Execute(Yapf().GetVehicle(), TraceRestrictProgramInput(tile, trackdir, &TraceRestrictPreviousSignalCallback, &n), out);
+			if (prog->HasEntryDirectionResults()) {
+				out = prog->GetEntryDirectionResult(trackdir);
+			} else {
+				prog->Execute(Yapf().GetVehicle(), TraceRestrictProgramInput(tile, trackdir, &TraceRestrictPreviousSignalCallback, &n), out);
+			}
 			if (out.flags & TRPRF_RESERVE_THROUGH && is_res_through != nullptr) {
 				*is_res_through = true;
 			}
@@ -10,6 +10,8 @@
 #ifndef YAPF_DESTRAIL_HPP
 #define YAPF_DESTRAIL_HPP
 
+#include "../../depot_kdtree.h"
+
 class CYapfDestinationRailBase {
 protected:
 	RailTypes m_compatible_railtypes;
@@ -59,12 +61,50 @@ public:
 	}
 
 	/**
-	 * Called by YAPF to calculate cost estimate. Calculates distance to the destination
+	 * Called by YAPF to calculate cost estimate. Calculates distance to the nearest rail depot
 	 *  adds it to the actual cost from origin and stores the sum to the Node::m_estimate
+	 *
+	 * The distance is the same octile estimate as used for a single destination tile, minimised over all rail depots.
+	 * The minimum of consistent estimates is itself consistent, so the search still finds the cheapest depot,
+	 * but nodes leading away from every depot are now expanded after those heading towards one.
 	 */
 	inline bool PfCalcEstimate(Node &n)
 	{
-		n.m_estimate = n.m_cost;
+		static const int dg_dir_to_x_offs[] = {-1, 0, 1, 0};
+		static const int dg_dir_to_y_offs[] = {0, 1, 0, -1};
+		const RailDepotKdtree &depots = GetRailDepotKdtree();
+		if (depots.Count() == 0 || PfDetectDestination(n)) {
+			n.m_estimate = n.m_cost;
+			return true;
+		}
+
+		TileIndex tile = n.GetLastTile();
+		DiagDirection exitdir = TrackdirToExitdir(n.GetLastTrackdir());
+		int x1 = 2 * TileX(tile) + dg_dir_to_x_offs[(int)exitdir];
+		int y1 = 2 * TileY(tile) + dg_dir_to_y_offs[(int)exitdir];
+
+		auto estimate = [&](TileIndex depot) -> int {
+			int dx = abs(x1 - 2 * (int)TileX(depot));
+			int dy = abs(y1 - 2 * (int)TileY(depot));
+			int dmin = min(dx, dy);
+			int dxy = abs(dx - dy);
+			return dmin * YAPF_TILE_CORNER_LENGTH + (dxy - 1) * (YAPF_TILE_LENGTH / 2);
+		};
+
+		/* Start from the closest depot by straight line distance, any depot with a lower
+		 * estimate must be within a half tile distance of best / (YAPF_TILE_LENGTH / 2) + 1 */
+		int best = estimate(depots.FindNearest(TileX(tile), TileY(tile)));
+		int radius = (best / (YAPF_TILE_LENGTH / 2) + 1) / 2 + 1;
+		uint16 rx1 = (uint16)max<int>(0, (int)TileX(tile) - radius);
+		uint16 rx2 = (uint16)min<int>(TileX(tile) + radius + 1, MapSizeX());
+		uint16 ry1 = (uint16)max<int>(0, (int)TileY(tile) - radius);
+		uint16 ry2 = (uint16)min<int>(TileY(tile) + radius + 1, MapSizeY());
+		depots.FindContained(rx1, ry1, rx2, ry2, [&](TileIndex depot) {
+			best = min(best, estimate(depot));
+		});
+
+		n.m_estimate = n.m_cost + best;
+		assert(n.m_estimate >= n.m_parent->m_estimate);
 		return true;
 	}
 };
@@ -0,0 +1,334 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file yapf_prefetch.cpp Prefetching of road vehicle and ship paths on background threads between game ticks.
+ *
+ * When the path cache of a road vehicle or ship is about to run out, the path beyond its end is
+ * queued during the game tick. At the end of the tick the queued paths are solved on background
+ * threads, while the main thread draws the screen. Nothing may change the game state until the
+ * results are applied, so #YapfFinishPathPrefetches is called before the next tick, before any
+ * command is executed between ticks and before saving or loading. Commands executed during the
+ * tick do not apply them, as scripts execute commands during the tick on the server only. The results therefore only depend on the
+ * game state at the end of the tick and are the same on all clients.
+ */
+
+#include "../../stdafx.h"
+#include "../../roadveh.h"
+#include "../../ship.h"
+#include "../../openttd.h"
+#include "../../settings_type.h"
+#include "../../thread.h"
+#include "../../debug.h"
+#include "../../core/checksum_func.hpp"
+#include "yapf.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#if defined(__MINGW32__)
+#include "../../3rdparty/mingw-std-threads/mingw.mutex.h"
+#include "../../3rdparty/mingw-std-threads/mingw.condition_variable.h"
+#endif
+
+#include "../../safeguards.h"
+
+/** Path of a road vehicle or ship to find beyond the end of its path cache. */
+struct PathPrefetchJob {
+	VehicleType type;            ///< Type of the vehicle.
+	VehicleID veh;               ///< The vehicle.
+	TileIndex tile;              ///< Tile of the last choice in the path cache (road vehicles) or the tile just chosen for (ships).
+	Trackdir td;                 ///< Trackdir of that choice.
+	size_t cache_size;           ///< Size of the path cache of the vehicle when queued.
+	bool path_found;             ///< Whether a path has been found.
+	RoadVehPathCache road_path;  ///< Choices to append to the path cache of a road vehicle.
+	ShipPathCache ship_cached;   ///< Path cache of a ship when queued.
+	ShipPathCache ship_path;     ///< Trackdirs to append to the path cache of a ship.
+};
+
+/** Background threads solving the queued path prefetches. */
+struct PathPrefetchers {
+	std::mutex lock;                        ///< Lock for #busy and #stop.
+	std::condition_variable work_available; ///< Signalled when jobs are started or the threads have to stop.
+	std::condition_variable work_done;      ///< Signalled when a thread stops working on the jobs.
+	std::vector<std::thread> threads;       ///< The prefetch threads.
+	std::vector<PathPrefetchJob> jobs;      ///< The jobs of the current tick, in queueing order.
+	std::atomic<size_t> next_job;           ///< Index of the next job for a thread to take.
+	uint busy = 0;                          ///< Number of threads working on the jobs.
+	bool running = false;                   ///< Whether the jobs have been started and not yet finished.
+	bool stop = false;                      ///< Whether the threads have to stop.
+	bool started = false;                   ///< Whether starting the threads has been attempted.
+};
+
+static PathPrefetchers _path_prefetchers;
+
+/**
+ * Check whether the vehicle of a path prefetch job still exists and its path cache did not change since the job was queued.
+ * Vehicles can be deleted or their pool slot reused after queueing, e.g. by autoreplace or by commands of scripts.
+ * Must be called on the main thread.
+ * @param job The job.
+ * @return True if the job can be solved and applied.
+ */
+static bool IsPathPrefetchJobValid(const PathPrefetchJob &job)
+{
+	switch (job.type) {
+		case VEH_ROAD: {
+			const RoadVehicle *v = RoadVehicle::GetIfValid(job.veh);
+			return v != nullptr && v->path.size() == job.cache_size && !v->path.empty() && v->path.tile.back() == job.tile && v->path.td.back() == job.td;
+		}
+
+		case VEH_SHIP: {
+			const Ship *v = Ship::GetIfValid(job.veh);
+			return v != nullptr && v->path == job.ship_cached;
+		}
+
+		default: NOT_REACHED();
+	}
+}
+
+/**
+ * Drop the path prefetch jobs which may no longer be solved, before handing them to the threads.
+ */
+static void DropInvalidPathPrefetchJobs()
+{
+	std::vector<PathPrefetchJob> &jobs = _path_prefetchers.jobs;
+	jobs.erase(std::remove_if(jobs.begin(), jobs.end(), [](const PathPrefetchJob &job) { return !IsPathPrefetchJobValid(job); }), jobs.end());
+}
+
+/**
+ * Solve a path prefetch job.
+ * The job must have been checked with #IsPathPrefetchJobValid since the game state last changed.
+ * @param job The job.
+ */
+static void SolvePathPrefetchJob(PathPrefetchJob &job)
+{
+	switch (job.type) {
+		case VEH_ROAD:
+			job.path_found = YapfRoadVehiclePrefetchPath(RoadVehicle::Get(job.veh), job.tile, job.td, job.road_path);
+			break;
+
+		case VEH_SHIP:
+			job.path_found = YapfShipPrefetchPath(Ship::Get(job.veh), job.tile, job.td, job.ship_cached, job.ship_path);
+			break;
+
+		default: NOT_REACHED();
+	}
+}
+
+/**
+ * Solve jobs until none are left to take.
+ */
+static void SolvePathPrefetchJobs()
+{
+	PathPrefetchers &pf = _path_prefetchers;
+	for (;;) {
+		size_t index = pf.next_job.fetch_add(1);
+		if (index >= pf.jobs.size()) return;
+		SolvePathPrefetchJob(pf.jobs[index]);
+	}
+}
+
+/** Main loop of the path prefetch threads. */
+static void PathPrefetchThread()
+{
+	PathPrefetchers &pf = _path_prefetchers;
+	std::unique_lock<std::mutex> lock(pf.lock);
+	for (;;) {
+		pf.work_available.wait(lock, [&]() { return pf.stop || (pf.running && pf.next_job < pf.jobs.size()); });
+		if (pf.stop) return;
+
+		pf.busy++;
+		lock.unlock();
+
+		SolvePathPrefetchJobs();
+
+		lock.lock();
+		pf.busy--;
+		pf.work_done.notify_all();
+	}
+}
+
+/**
+ * Start the path prefetch threads, if not done already.
+ */
+static void StartPathPrefetchers()
+{
+	PathPrefetchers &pf = _path_prefetchers;
+	if (pf.started) return;
+	pf.started = true;
+
+	/* Leave one core for the main thread. */
+	uint count = min<uint>(std::thread::hardware_concurrency(), 3);
+	for (uint i = 1; i < count; i++) {
+		std::thread thread;
+		if (!StartNewThread(&thread, "ottd:pathpf", &PathPrefetchThread)) break;
+		pf.threads.push_back(std::move(thread));
+	}
+	DEBUG(yapf, 3, "Started " PRINTF_SIZE " path prefetch threads", pf.threads.size());
+}
+
+/**
+ * Whether paths are prefetched for vehicles of the given pathfinder.
+ * @param pathfinder The pathfinder setting of the vehicle type.
+ * @return True if paths are prefetched.
+ */
+static bool IsPathPrefetchEnabled(uint8 pathfinder)
+{
+	return _settings_game.pf.yapf.prefetch_road_ship_paths && pathfinder == VPF_YAPF && _game_mode == GM_NORMAL;
+}
+
+/**
+ * Queue finding the path choices following the last choice in the path cache of a road vehicle.
+ * @param v The road vehicle.
+ */
+void YapfQueueRoadVehiclePathPrefetch(const RoadVehicle *v)
+{
+	if (!IsPathPrefetchEnabled(_settings_game.pf.pathfinder_for_roadvehs) || v->path.empty()) return;
+	assert(!_path_prefetchers.running);
+
+	PathPrefetchJob job = {};
+	job.type = VEH_ROAD;
+	job.veh = v->index;
+	job.tile = v->path.tile.back();
+	job.td = v->path.td.back();
+	job.cache_size = v->path.size();
+	_path_prefetchers.jobs.push_back(std::move(job));
+}
+
+/**
+ * Queue finding the path of a ship beyond the end of its path cache.
+ * @param v The ship.
+ * @param tile The tile the ship has just chosen a trackdir for from its path cache.
+ * @param td The trackdir chosen.
+ */
+void YapfQueueShipPathPrefetch(const Ship *v, TileIndex tile, Trackdir td)
+{
+	if (!IsPathPrefetchEnabled(_settings_game.pf.pathfinder_for_ships)) return;
+	assert(!_path_prefetchers.running);
+
+	PathPrefetchJob job = {};
+	job.type = VEH_SHIP;
+	job.veh = v->index;
+	job.tile = tile;
+	job.td = td;
+	job.cache_size = v->path.size();
+	job.ship_cached = v->path;
+	_path_prefetchers.jobs.push_back(std::move(job));
+}
+
+/**
+ * Start solving the path prefetches queued during this tick on the background threads.
+ * Must be called at the end of the game tick, after which nothing may change the game state until #YapfFinishPathPrefetches.
+ */
+void YapfStartPathPrefetches()
+{
+	PathPrefetchers &pf = _path_prefetchers;
+	if (pf.running) return;
+	DropInvalidPathPrefetchJobs();
+	if (pf.jobs.empty()) return;
+
+	StartPathPrefetchers();
+	{
+		std::lock_guard<std::mutex> lock(pf.lock);
+		pf.next_job = 0;
+		pf.running = true;
+	}
+	pf.work_available.notify_all();
+}
+
+/**
+ * Apply a solved path prefetch job to its vehicle, if its path cache did not change since the job was queued.
+ * @param job The job.
+ */
+static void ApplyPathPrefetchJob(PathPrefetchJob &job)
+{
+	switch (job.type) {
+		case VEH_ROAD: {
+			if (!job.path_found || job.road_path.empty() || !IsPathPrefetchJobValid(job)) return;
+			RoadVehicle *v = RoadVehicle::Get(job.veh);
+			if (v->path.layout_ctr != job.road_path.layout_ctr) return;
+
+			v->path.td.insert(v->path.td.end(), job.road_path.td.begin(), job.road_path.td.end());
+			v->path.tile.insert(v->path.tile.end(), job.road_path.tile.begin(), job.road_path.tile.end());
+			UpdateStateChecksum((((uint64) v->index) << 32) | v->path.size());
+			break;
+		}
+
+		case VEH_SHIP: {
+			if (!job.path_found || job.ship_path.empty() || !IsPathPrefetchJobValid(job)) return;
+			Ship *v = Ship::Get(job.veh);
+
+			v->path.insert(v->path.end(), job.ship_path.begin(), job.ship_path.end());
+			UpdateStateChecksum((((uint64) v->index) << 32) | v->path.size());
+			break;
+		}
+
+		default: NOT_REACHED();
+	}
+}
+
+/**
+ * Wait for the path prefetches of the last tick to be solved and apply them to their vehicles.
+ * Solves any jobs which were not started yet on the calling thread.
+ * Must be called before anything changes the game state after #YapfStartPathPrefetches.
+ */
+void YapfFinishPathPrefetches()
+{
+	PathPrefetchers &pf = _path_prefetchers;
+	if (pf.jobs.empty()) return;
+
+	if (!pf.running) {
+		/* Queued during a tick which has not finished, e.g. when saving from within the game loop. */
+		DropInvalidPathPrefetchJobs();
+		pf.next_job = 0;
+	}
+	SolvePathPrefetchJobs();
+	{
+		std::unique_lock<std::mutex> lock(pf.lock);
+		pf.work_done.wait(lock, [&]() { return pf.busy == 0; });
+		pf.running = false;
+	}
+
+	for (PathPrefetchJob &job : pf.jobs) {
+		ApplyPathPrefetchJob(job);
+	}
+	pf.jobs.clear();
+}
+
+/**
+ * Wait for the path prefetches started at the end of the last tick and apply them, if any.
+ * Does nothing during the game tick, such as for commands of scripts run from within #StateGameLoop,
+ * as the jobs queued so far may only be applied at the tick boundary like on all other clients.
+ */
+void YapfFinishStartedPathPrefetches()
+{
+	if (!_path_prefetchers.running) return;
+	YapfFinishPathPrefetches();
+}
+
+/**
+ * Discard any queued path prefetches and stop the path prefetch threads.
+ */
+void YapfStopPathPrefetchers()
+{
+	PathPrefetchers &pf = _path_prefetchers;
+	{
+		std::unique_lock<std::mutex> lock(pf.lock);
+		pf.next_job = pf.jobs.size();
+		pf.work_done.wait(lock, [&]() { return pf.busy == 0; });
+		pf.running = false;
+		pf.stop = true;
+	}
+	pf.work_available.notify_all();
+	for (std::thread &thread : pf.threads) {
+		thread.join();
+	}
+	pf.threads.clear();
+	pf.jobs.clear();
+	pf.stop = false;
+	pf.started = false;
+}
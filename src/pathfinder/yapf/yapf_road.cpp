@@ -396,6 +396,40 @@ public:
 		path_found = Yapf().FindPath(v);
 
 		/* if path not found - return INVALID_TRACKDIR */
+		return StorePathCache(v, tile, path_found, path_cache);
+	}
+
+	static bool stPrefetchRoadPath(const RoadVehicle *v, TileIndex tile, Trackdir td, RoadVehPathCache &path_cache)
+	{
+		Tpf pf;
+		return pf.PrefetchRoadPath(v, tile, td, path_cache);
+	}
+
+	inline bool PrefetchRoadPath(const RoadVehicle *v, TileIndex tile, Trackdir td, RoadVehPathCache &path_cache)
+	{
+		/* The vehicle takes the special case path in ChooseRoadTrack on the destination tile */
+		if (tile == v->dest_tile) return false;
+
+		/* search on from the last choice in the path cache, which is not part of the result */
+		Yapf().m_prefetch = true;
+		Yapf().SetOrigin(tile, TrackdirToTrackdirBits(td));
+		Yapf().SetDestination(v);
+
+		bool path_found = Yapf().FindPath(v);
+		StorePathCache(v, tile, path_found, path_cache);
+		return path_found;
+	}
+
+	/**
+	 * Store the choices along the best path found into a path cache.
+	 * @param v The road vehicle.
+	 * @param tile The origin tile of the search.
+	 * @param path_found Whether the destination was found.
+	 * @param path_cache [out] The path cache.
+	 * @return The trackdir of the best origin node, or INVALID_TRACKDIR if there is none.
+	 */
+	inline Trackdir StorePathCache(const RoadVehicle *v, TileIndex tile, bool path_found, RoadVehPathCache &path_cache)
+	{
 		Trackdir next_trackdir = INVALID_TRACKDIR;
 		Node *pNode = Yapf().GetBestNode();
 		if (pNode != nullptr) {
@@ -544,6 +578,20 @@ struct CYapfRoadAnyDepot1 : CYapfT<CYapfRoad_TypesT<CYapfRoadAnyDepot1, CRoadNod
 struct CYapfRoadAnyDepot2 : CYapfT<CYapfRoad_TypesT<CYapfRoadAnyDepot2, CRoadNodeListExitDir , CYapfDestinationAnyDepotRoadT> > {};
 
 
+bool YapfRoadVehiclePrefetchPath(const RoadVehicle *v, TileIndex tile, Trackdir td, RoadVehPathCache &path_cache)
+{
+	/* default is YAPF type 2 */
+	typedef bool (*PfnPrefetchRoadPath)(const RoadVehicle*, TileIndex, Trackdir, RoadVehPathCache &path_cache);
+	PfnPrefetchRoadPath pfnPrefetchRoadPath = &CYapfRoad2::stPrefetchRoadPath; // default: ExitDir, allow 90-deg
+
+	/* check if non-default YAPF type should be used */
+	if (_settings_game.pf.yapf.disable_node_optimization) {
+		pfnPrefetchRoadPath = &CYapfRoad1::stPrefetchRoadPath; // Trackdir
+	}
+
+	return pfnPrefetchRoadPath(v, tile, td, path_cache);
+}
+
 Trackdir YapfRoadVehicleChooseTrack(const RoadVehicle *v, TileIndex tile, DiagDirection enterdir, TrackdirBits trackdirs, bool &path_found, RoadVehPathCache &path_cache)
 {
 	/* default is YAPF type 2 */
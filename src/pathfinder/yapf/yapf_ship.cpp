@@ -197,6 +197,49 @@ public:
 		return next_trackdir;
 	}
 
+	static bool PrefetchShipPath(const Ship *v, TileIndex tile, Trackdir td, const ShipPathCache &current, ShipPathCache &path_cache)
+	{
+		/* follow the cached path to the tile and trackdir it ends with */
+		TrackFollower F(v);
+		for (Trackdir next_td : current) {
+			if (!F.Follow(tile, td) || !HasTrackdir(F.m_new_td_bits, next_td)) return false;
+			tile = F.m_new_tile;
+			td = next_td;
+		}
+		if (tile == v->dest_tile) return false;
+
+		/* create pathfinder instance */
+		Tpf pf;
+		pf.m_prefetch = true;
+		/* set origin and destination nodes, the origin is already part of the cached path */
+		pf.SetOrigin(tile, TrackdirToTrackdirBits(td));
+		pf.SetDestination(v);
+		/* find best path */
+		bool path_found = pf.FindPath(v);
+
+		Node *pNode = pf.GetBestNode();
+		if (pNode == nullptr) return false;
+
+		uint steps = 0;
+		for (Node *n = pNode; n->m_parent != nullptr; n = n->m_parent) steps++;
+		uint skip = 0;
+		if (path_found) skip = YAPF_SHIP_PATH_CACHE_LENGTH / 2;
+
+		/* walk through the path back to the origin */
+		while (pNode->m_parent != nullptr) {
+			steps--;
+			/* Skip tiles at end of path near destination. */
+			if (skip > 0) skip--;
+			if (skip == 0 && steps < YAPF_SHIP_PATH_CACHE_LENGTH - current.size()) {
+				path_cache.push_front(pNode->GetTrackdir());
+			}
+			pNode = pNode->m_parent;
+		}
+		/* remove last element for the special case when tile == dest_tile */
+		if (path_found && !path_cache.empty()) path_cache.pop_back();
+		return path_found;
+	}
+
 	/**
 	 * Check whether a ship should reverse to reach its destination.
 	 * Called when leaving depot.
@@ -363,6 +406,20 @@ Track YapfShipChooseTrack(const Ship *v, TileIndex tile, DiagDirection enterdir,
 	return (td_ret != INVALID_TRACKDIR) ? TrackdirToTrack(td_ret) : INVALID_TRACK;
 }
 
+bool YapfShipPrefetchPath(const Ship *v, TileIndex tile, Trackdir td, const ShipPathCache &current, ShipPathCache &path_cache)
+{
+	/* default is YAPF type 2 */
+	typedef bool (*PfnPrefetchShipPath)(const Ship*, TileIndex, Trackdir, const ShipPathCache &current, ShipPathCache &path_cache);
+	PfnPrefetchShipPath pfnPrefetchShipPath = CYapfShip2::PrefetchShipPath; // default: ExitDir
+
+	/* check if non-default YAPF type needed */
+	if (_settings_game.pf.yapf.disable_node_optimization || RequireTrackdirKey()) {
+		pfnPrefetchShipPath = &CYapfShip1::PrefetchShipPath; // Trackdir
+	}
+
+	return pfnPrefetchShipPath(v, tile, td, current, path_cache);
+}
+
 bool YapfShipCheckReverse(const Ship *v)
 {
 	Trackdir td = v->GetVehicleTrackdir();
@@ -12,6 +12,7 @@
 #include "viewport_func.h"
 #include "command_func.h"
 #include "depot_base.h"
+#include "depot_kdtree.h"
 #include "pathfinder/yapf/yapf_cache.h"
 #include "newgrf_debug.h"
 #include "newgrf_railtype.h"
@@ -1241,6 +1242,7 @@ CommandCost CmdBuildTrainDepot(TileIndex tile, DoCommandFlag flags, uint32 p1, u
 		d->build_date = _date;
 
 		MakeRailDepot(tile, _current_company, d->index, dir, railtype);
+		InvalidateRailDepotKdtree();
 		MarkTileDirtyByTile(tile);
 		MakeDefaultName(d);
 
@@ -1050,6 +1050,7 @@ static Trackdir RoadFindPathToDest(RoadVehicle *v, TileIndex tile, DiagDirection
 			if (HasBit(trackdirs, trackdir)) {
 				v->path.td.pop_front();
 				v->path.tile.pop_front();
+				if (v->path.size() == YAPF_ROADVEH_PATH_CACHE_PREFETCH) YapfQueueRoadVehiclePathPrefetch(v);
 				return_track(trackdir);
 			}
 
@@ -19,6 +19,7 @@
 #include "../gfxinit.h"
 #include "../viewport_func.h"
 #include "../viewport_kdtree.h"
+#include "../depot_kdtree.h"
 #include "../industry.h"
 #include "../clear_map.h"
 #include "../vehicle_func.h"
@@ -27,6 +28,7 @@
 #include "../roadveh.h"
 #include "../train.h"
 #include "../station_base.h"
+#include "../station_func.h"
 #include "../waypoint_base.h"
 #include "../roadstop_base.h"
 #include "../tunnelbridge_map.h"
@@ -623,6 +625,7 @@ bool AfterLoadGame()
 
 	RebuildTownKdtree();
 	RebuildStationKdtree();
+	InvalidateRailDepotKdtree();
 
 	_viewport_sign_kdtree_valid = false;
 
@@ -2459,21 +2462,13 @@ bool AfterLoadGame()
 
 		extern std::vector<TileIndex> _animated_tiles;
 
-		for (auto tile = _animated_tiles.begin(); tile < _animated_tiles.end(); /* Nothing */) {
-			/* Remove if tile is not animated */
-			bool remove = _tile_type_procs[GetTileType(*tile)]->animate_tile_proc == nullptr;
+		/* Remove if tile is not animated */
+		_animated_tiles.erase(std::remove_if(_animated_tiles.begin(), _animated_tiles.end(), [](TileIndex tile) -> bool {
+			return _tile_type_procs[GetTileType(tile)]->animate_tile_proc == nullptr;
+		}), _animated_tiles.end());
 
-			/* and remove if duplicate */
-			for (auto j = _animated_tiles.begin(); !remove && j < tile; j++) {
-				remove = *tile == *j;
-			}
-
-			if (remove) {
-				tile = _animated_tiles.erase(tile);
-			} else {
-				tile++;
-			}
-		}
+		/* This also removes duplicates */
+		RebuildAnimatedTileIndex();
 	}
 
 	if (IsSavegameVersionBefore(SLV_124) && !IsSavegameVersionBefore(SLV_1)) {
@@ -3791,6 +3786,7 @@ bool AfterLoadGame()
 
 	/* Road stops is 'only' updating some caches */
 	AfterLoadRoadStops();
+	RebuildStationRatingSchedule();
 	AfterLoadLabelMaps();
 	AfterLoadCompanyStats();
 	AfterLoadStoryBook();
@@ -3855,6 +3851,8 @@ void ReloadNewGRFData()
 	GfxLoadSprites();
 	LoadStringWidthTable();
 	RecomputePrices();
+	/* rail type properties may have changed */
+	YapfNotifyTrackLayoutChange(INVALID_TILE, INVALID_TRACK);
 	/* reload vehicles */
 	ResetVehicleHash();
 	AfterLoadVehicles(false);
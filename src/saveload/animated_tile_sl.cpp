@@ -9,6 +9,7 @@
 
 #include "../stdafx.h"
 #include "../tile_type.h"
+#include "../animated_tile_func.h"
 #include "../core/alloc_func.hpp"
 #include "../core/smallvec_type.hpp"
 
@@ -23,6 +24,7 @@ extern std::vector<TileIndex> _animated_tiles;
  */
 static void Save_ANIT()
 {
+	CompactAnimatedTiles();
 	SlSetLength(_animated_tiles.size() * sizeof(_animated_tiles.front()));
 	SlArray(_animated_tiles.data(), _animated_tiles.size(), SLE_UINT32);
 }
@@ -42,6 +44,7 @@ static void Load_ANIT()
 			if (anim_list[i] == 0) break;
 			_animated_tiles.push_back(anim_list[i]);
 		}
+		RebuildAnimatedTileIndex();
 		return;
 	}
 
@@ -49,6 +52,7 @@ static void Load_ANIT()
 	_animated_tiles.clear();
 	_animated_tiles.resize(_animated_tiles.size() + count);
 	SlArray(_animated_tiles.data(), count, SLE_UINT32);
+	RebuildAnimatedTileIndex();
 }
 
 /**
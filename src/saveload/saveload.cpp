@@ -43,6 +43,7 @@
 #include "../string_func_extra.h"
 #include "../fios.h"
 #include "../error.h"
+#include "../pathfinder/yapf/yapf.h"
 #include <atomic>
 #include <string>
 
@@ -3005,6 +3006,9 @@ static SaveOrLoadResult DoSave(SaveFilter *writer, bool threaded)
 {
 	assert(!_sl.saveinprogress);
 
+	/* Path prefetches not yet applied are part of the game state. */
+	YapfFinishPathPrefetches();
+
 	_sl.dumper = new MemoryDumper();
 	_sl.sf = writer;
 
@@ -3161,6 +3165,8 @@ static SaveOrLoadResult DoLoad(LoadFilter *reader, bool load_check)
 {
 	_sl.lf = reader;
 
+	if (!load_check) YapfFinishPathPrefetches();
+
 	if (load_check) {
 		/* Clear previous check data */
 		_load_check_data.Clear();
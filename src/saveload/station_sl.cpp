@@ -9,6 +9,7 @@
 
 #include "../stdafx.h"
 #include "../station_base.h"
+#include "../station_func.h"
 #include "../waypoint_base.h"
 #include "../roadstop_base.h"
 #include "../vehicle_base.h"
@@ -558,6 +559,9 @@ static void Save_STNN()
 {
 	SetupDescs_STNN();
 
+	/* Bring the rating counters, which are saved as delete_ctr, up to date */
+	SyncStationRatingCounters();
+
 	/* Write the stations */
 	for (BaseStation *st : BaseStation::Iterate()) {
 		SlSetArrayIndex(st->index);
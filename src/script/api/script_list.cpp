@@ -17,12 +17,27 @@
 
 /**
  * Base class for any ScriptList sorter.
+ * Sorters remember the key of the next item, rather than an iterator, so that
+ * modifications of the list do not invalidate them. The successor of that key
+ * is looked up when advancing.
  */
 class ScriptListSorter {
 protected:
 	ScriptList *list;       ///< The list that's being sorted.
 	bool has_no_more_items; ///< Whether we have more items to iterate over.
+	bool has_next;          ///< Whether item_next refers to an item, false when we went past the last item.
 	int64 item_next;        ///< The next item we will show.
+	int64 value_next;       ///< The value of the next item, for sorters by value.
+
+	/**
+	 * Get the items of the list sorted by value.
+	 * @return The value index of the list, brought up to date when needed.
+	 */
+	ScriptList::ScriptListValueSet &Values()
+	{
+		this->list->UpdateValues();
+		return this->list->values;
+	}
 
 public:
 	/**
@@ -38,33 +53,59 @@ public:
 	/**
 	 * Stop iterating a sorter.
 	 */
-	virtual void End() = 0;
+	void End()
+	{
+		this->has_no_more_items = true;
+		this->has_next = false;
+		this->item_next = 0;
+		this->value_next = 0;
+	}
+
+	/**
+	 * Find the next item, and store that information.
+	 */
+	virtual void FindNext() = 0;
 
 	/**
 	 * Get the next item of the sorter.
 	 */
-	virtual int64 Next() = 0;
+	int64 Next()
+	{
+		if (this->IsEnd()) return 0;
+
+		int64 item_current = this->item_next;
+		this->FindNext();
+		return item_current;
+	}
 
 	/**
 	 * See if the sorter has reached the end.
 	 */
 	bool IsEnd()
 	{
-		return this->list->buckets.empty() || this->has_no_more_items;
+		return this->list->items.empty() || this->has_no_more_items;
 	}
 
 	/**
 	 * Callback from the list if an item gets removed.
 	 */
-	virtual void Remove(int item) = 0;
+	void Remove(int item)
+	{
+		if (this->IsEnd()) return;
+
+		/* If we remove the 'next' item, skip to the next */
+		if (item == this->item_next) {
+			this->FindNext();
+			return;
+		}
+	}
 
 	/**
 	 * Attach the sorter to a new list. This assumes the content of the old list has been moved to
-	 * the new list, too, so that we don't have to invalidate any iterators. Note that std::swap
-	 * doesn't invalidate iterators on lists and maps, so that should be safe.
+	 * the new list, too. As sorters do not keep iterators, nothing else needs to be updated.
 	 * @param target New list to attach to.
 	 */
-	virtual void Retarget(ScriptList *new_list)
+	void Retarget(ScriptList *new_list)
 	{
 		this->list = new_list;
 	}
@@ -74,11 +115,6 @@ public:
  * Sort by value, ascending.
  */
 class ScriptListSorterValueAscending : public ScriptListSorter {
-private:
-	ScriptList::ScriptListBucket::iterator bucket_iter;    ///< The iterator over the list to find the buckets.
-	ScriptList::ScriptItemList *bucket_list;               ///< The current bucket list we're iterator over.
-	ScriptList::ScriptItemList::iterator bucket_list_iter; ///< The iterator over the bucket list.
-
 public:
 	/**
 	 * Create a new sorter.
@@ -92,67 +128,34 @@ public:
 
 	int64 Begin()
 	{
-		if (this->list->buckets.empty()) return 0;
+		if (this->list->items.empty()) return 0;
 		this->has_no_more_items = false;
 
-		this->bucket_iter = this->list->buckets.begin();
-		this->bucket_list = &(*this->bucket_iter).second;
-		this->bucket_list_iter = this->bucket_list->begin();
-		this->item_next = *this->bucket_list_iter;
+		ScriptList::ScriptListValueSet::iterator iter = this->Values().begin();
+		this->has_next = true;
+		this->value_next = iter->first;
+		this->item_next = iter->second;
 
 		int64 item_current = this->item_next;
 		FindNext();
 		return item_current;
 	}
 
-	void End()
-	{
-		this->bucket_list = nullptr;
-		this->has_no_more_items = true;
-		this->item_next = 0;
-	}
-
-	/**
-	 * Find the next item, and store that information.
-	 */
 	void FindNext()
 	{
-		if (this->bucket_list == nullptr) {
+		if (!this->has_next) {
 			this->has_no_more_items = true;
 			return;
 		}
 
-		this->bucket_list_iter++;
-		if (this->bucket_list_iter == this->bucket_list->end()) {
-			this->bucket_iter++;
-			if (this->bucket_iter == this->list->buckets.end()) {
-				this->bucket_list = nullptr;
-				return;
-			}
-			this->bucket_list = &(*this->bucket_iter).second;
-			this->bucket_list_iter = this->bucket_list->begin();
-		}
-		this->item_next = *this->bucket_list_iter;
-	}
-
-	int64 Next()
-	{
-		if (this->IsEnd()) return 0;
-
-		int64 item_current = this->item_next;
-		FindNext();
-		return item_current;
-	}
-
-	void Remove(int item)
-	{
-		if (this->IsEnd()) return;
-
-		/* If we remove the 'next' item, skip to the next */
-		if (item == this->item_next) {
-			FindNext();
+		ScriptList::ScriptListValueSet &values = this->Values();
+		ScriptList::ScriptListValueSet::iterator iter = values.upper_bound(std::make_pair(this->value_next, this->item_next));
+		if (iter == values.end()) {
+			this->has_next = false;
 			return;
 		}
+		this->value_next = iter->first;
+		this->item_next = iter->second;
 	}
 };
 
@@ -160,14 +163,6 @@ public:
  * Sort by value, descending.
  */
 class ScriptListSorterValueDescending : public ScriptListSorter {
-private:
-	/* Note: We cannot use reverse_iterator.
-	 *       The iterators must only be invalidated when the element they are pointing to is removed.
-	 *       This only holds for forward iterators. */
-	ScriptList::ScriptListBucket::iterator bucket_iter;    ///< The iterator over the list to find the buckets.
-	ScriptList::ScriptItemList *bucket_list;               ///< The current bucket list we're iterator over.
-	ScriptList::ScriptItemList::iterator bucket_list_iter; ///< The iterator over the bucket list.
-
 public:
 	/**
 	 * Create a new sorter.
@@ -181,75 +176,37 @@ public:
 
 	int64 Begin()
 	{
-		if (this->list->buckets.empty()) return 0;
+		if (this->list->items.empty()) return 0;
 		this->has_no_more_items = false;
 
-		/* Go to the end of the bucket-list */
-		this->bucket_iter = this->list->buckets.end();
-		--this->bucket_iter;
-		this->bucket_list = &(*this->bucket_iter).second;
-
-		/* Go to the end of the items in the bucket */
-		this->bucket_list_iter = this->bucket_list->end();
-		--this->bucket_list_iter;
-		this->item_next = *this->bucket_list_iter;
+		/* Go to the end of the list */
+		ScriptList::ScriptListValueSet::iterator iter = this->Values().end();
+		--iter;
+		this->has_next = true;
+		this->value_next = iter->first;
+		this->item_next = iter->second;
 
 		int64 item_current = this->item_next;
 		FindNext();
 		return item_current;
 	}
 
-	void End()
-	{
-		this->bucket_list = nullptr;
-		this->has_no_more_items = true;
-		this->item_next = 0;
-	}
-
-	/**
-	 * Find the next item, and store that information.
-	 */
 	void FindNext()
 	{
-		if (this->bucket_list == nullptr) {
+		if (!this->has_next) {
 			this->has_no_more_items = true;
 			return;
 		}
 
-		if (this->bucket_list_iter == this->bucket_list->begin()) {
-			if (this->bucket_iter == this->list->buckets.begin()) {
-				this->bucket_list = nullptr;
-				return;
-			}
-			this->bucket_iter--;
-			this->bucket_list = &(*this->bucket_iter).second;
-			/* Go to the end of the items in the bucket */
-			this->bucket_list_iter = this->bucket_list->end();
-			--this->bucket_list_iter;
-		} else {
-			this->bucket_list_iter--;
-		}
-		this->item_next = *this->bucket_list_iter;
-	}
-
-	int64 Next()
-	{
-		if (this->IsEnd()) return 0;
-
-		int64 item_current = this->item_next;
-		FindNext();
-		return item_current;
-	}
-
-	void Remove(int item)
-	{
-		if (this->IsEnd()) return;
-
-		/* If we remove the 'next' item, skip to the next */
-		if (item == this->item_next) {
-			FindNext();
+		ScriptList::ScriptListValueSet &values = this->Values();
+		ScriptList::ScriptListValueSet::iterator iter = values.lower_bound(std::make_pair(this->value_next, this->item_next));
+		if (iter == values.begin()) {
+			this->has_next = false;
 			return;
 		}
+		--iter;
+		this->value_next = iter->first;
+		this->item_next = iter->second;
 	}
 };
 
@@ -257,9 +214,6 @@ public:
  * Sort by item, ascending.
  */
 class ScriptListSorterItemAscending : public ScriptListSorter {
-private:
-	ScriptList::ScriptListMap::iterator item_iter; ///< The iterator over the items in the map.
-
 public:
 	/**
 	 * Create a new sorter.
@@ -276,50 +230,27 @@ public:
 		if (this->list->items.empty()) return 0;
 		this->has_no_more_items = false;
 
-		this->item_iter = this->list->items.begin();
-		this->item_next = (*this->item_iter).first;
+		this->has_next = true;
+		this->item_next = this->list->items.begin()->first;
 
 		int64 item_current = this->item_next;
 		FindNext();
 		return item_current;
 	}
 
-	void End()
-	{
-		this->has_no_more_items = true;
-	}
-
-	/**
-	 * Find the next item, and store that information.
-	 */
 	void FindNext()
 	{
-		if (this->item_iter == this->list->items.end()) {
+		if (!this->has_next) {
 			this->has_no_more_items = true;
 			return;
 		}
-		this->item_iter++;
-		if (this->item_iter != this->list->items.end()) item_next = (*this->item_iter).first;
-	}
-
-	int64 Next()
-	{
-		if (this->IsEnd()) return 0;
-
-		int64 item_current = this->item_next;
-		FindNext();
-		return item_current;
-	}
 
-	void Remove(int item)
-	{
-		if (this->IsEnd()) return;
-
-		/* If we remove the 'next' item, skip to the next */
-		if (item == this->item_next) {
-			FindNext();
+		ScriptList::ScriptListMap::iterator iter = this->list->items.upper_bound(this->item_next);
+		if (iter == this->list->items.end()) {
+			this->has_next = false;
 			return;
 		}
+		this->item_next = iter->first;
 	}
 };
 
@@ -327,12 +258,6 @@ public:
  * Sort by item, descending.
  */
 class ScriptListSorterItemDescending : public ScriptListSorter {
-private:
-	/* Note: We cannot use reverse_iterator.
-	 *       The iterators must only be invalidated when the element they are pointing to is removed.
-	 *       This only holds for forward iterators. */
-	ScriptList::ScriptListMap::iterator item_iter; ///< The iterator over the items in the map.
-
 public:
 	/**
 	 * Create a new sorter.
@@ -349,56 +274,30 @@ public:
 		if (this->list->items.empty()) return 0;
 		this->has_no_more_items = false;
 
-		this->item_iter = this->list->items.end();
-		--this->item_iter;
-		this->item_next = (*this->item_iter).first;
+		ScriptList::ScriptListMap::iterator iter = this->list->items.end();
+		--iter;
+		this->has_next = true;
+		this->item_next = iter->first;
 
 		int64 item_current = this->item_next;
 		FindNext();
 		return item_current;
 	}
 
-	void End()
-	{
-		this->has_no_more_items = true;
-	}
-
-	/**
-	 * Find the next item, and store that information.
-	 */
 	void FindNext()
 	{
-		if (this->item_iter == this->list->items.end()) {
+		if (!this->has_next) {
 			this->has_no_more_items = true;
 			return;
 		}
-		if (this->item_iter == this->list->items.begin()) {
-			/* Use 'end' as marker for 'beyond begin' */
-			this->item_iter = this->list->items.end();
-		} else {
-			this->item_iter--;
-		}
-		if (this->item_iter != this->list->items.end()) item_next = (*this->item_iter).first;
-	}
 
-	int64 Next()
-	{
-		if (this->IsEnd()) return 0;
-
-		int64 item_current = this->item_next;
-		FindNext();
-		return item_current;
-	}
-
-	void Remove(int item)
-	{
-		if (this->IsEnd()) return;
-
-		/* If we remove the 'next' item, skip to the next */
-		if (item == this->item_next) {
-			FindNext();
+		ScriptList::ScriptListMap::iterator iter = this->list->items.lower_bound(this->item_next);
+		if (iter == this->list->items.begin()) {
+			this->has_next = false;
 			return;
 		}
+		--iter;
+		this->item_next = iter->first;
 	}
 };
 
@@ -412,6 +311,7 @@ ScriptList::ScriptList()
 	this->sort_ascending = false;
 	this->initialized    = false;
 	this->modifications  = 0;
+	this->values_valid   = true;
 }
 
 ScriptList::~ScriptList()
@@ -419,6 +319,48 @@ ScriptList::~ScriptList()
 	delete this->sorter;
 }
 
+/**
+ * Rebuild the value index of the list if it is not up to date.
+ * The index is dropped by bulk changes of values, such as Valuate, and rebuilt in one go when it is next needed.
+ */
+void ScriptList::UpdateValues()
+{
+	if (this->values_valid) return;
+
+	std::vector<std::pair<int64, int64>> sorted;
+	sorted.reserve(this->items.size());
+	for (ScriptListMap::const_iterator iter = this->items.begin(); iter != this->items.end(); ++iter) {
+		sorted.emplace_back(iter->second, iter->first);
+	}
+	std::sort(sorted.begin(), sorted.end());
+
+	this->values.clear();
+	for (const auto &it : sorted) {
+		this->values.insert(this->values.end(), it);
+	}
+	this->values_valid = true;
+}
+
+/**
+ * Remove all items with a value in the given range.
+ * @param start The lowest value to remove, inclusive.
+ * @param end The highest value to remove, inclusive.
+ */
+void ScriptList::RemoveValueRange(int64 start, int64 end)
+{
+	if (start > end) return;
+
+	this->UpdateValues();
+
+	std::vector<int64> to_remove;
+	for (ScriptListValueSet::const_iterator iter = this->values.lower_bound(std::make_pair(start, INT64_MIN)); iter != this->values.end() && iter->first <= end; ++iter) {
+		to_remove.push_back(iter->second);
+	}
+	for (int64 item : to_remove) {
+		this->RemoveItem(item);
+	}
+}
+
 bool ScriptList::HasItem(int64 item)
 {
 	return this->items.count(item) == 1;
@@ -429,7 +371,8 @@ void ScriptList::Clear()
 	this->modifications++;
 
 	this->items.clear();
-	this->buckets.clear();
+	this->values.clear();
+	this->values_valid = true;
 	this->sorter->End();
 }
 
@@ -440,7 +383,7 @@ void ScriptList::AddItem(int64 item, int64 value)
 	if (this->HasItem(item)) return;
 
 	this->items[item] = value;
-	this->buckets[value].insert(item);
+	if (this->values_valid) this->values.insert(std::make_pair(value, item));
 }
 
 void ScriptList::RemoveItem(int64 item)
@@ -453,11 +396,12 @@ void ScriptList::RemoveItem(int64 item)
 	int64 value = item_iter->second;
 
 	this->sorter->Remove(item);
-	ScriptListBucket::iterator bucket_iter = this->buckets.find(value);
-	assert(bucket_iter != this->buckets.end());
-	bucket_iter->second.erase(item);
-	if (bucket_iter->second.empty()) this->buckets.erase(bucket_iter);
-	this->items.erase(item_iter);
+	if (this->values_valid) {
+		int removed = this->values.erase(std::make_pair(value, item));
+		assert(removed == 1);
+		(void)removed;
+	}
+	this->items.erase(item);
 }
 
 int64 ScriptList::Begin()
@@ -511,12 +455,13 @@ bool ScriptList::SetValue(int64 item, int64 value)
 	if (value_old == value) return true;
 
 	this->sorter->Remove(item);
-	ScriptListBucket::iterator bucket_iter = this->buckets.find(value_old);
-	assert(bucket_iter != this->buckets.end());
-	bucket_iter->second.erase(item);
-	if (bucket_iter->second.empty()) this->buckets.erase(bucket_iter);
+	if (this->values_valid) {
+		int removed = this->values.erase(std::make_pair(value_old, item));
+		assert(removed == 1);
+		(void)removed;
+		this->values.insert(std::make_pair(value, item));
+	}
 	item_iter->second = value;
-	this->buckets[value].insert(item);
 
 	return true;
 }
@@ -560,7 +505,8 @@ void ScriptList::AddList(ScriptList *list)
 	if (this->IsEmpty()) {
 		/* If this is empty, we can just take the items of the other list as is. */
 		this->items = list->items;
-		this->buckets = list->buckets;
+		this->values = list->values;
+		this->values_valid = list->values_valid;
 		this->modifications++;
 	} else {
 		ScriptListMap *list_items = &list->items;
@@ -576,7 +522,8 @@ void ScriptList::SwapList(ScriptList *list)
 	if (list == this) return;
 
 	this->items.swap(list->items);
-	this->buckets.swap(list->buckets);
+	this->values.swap(list->values);
+	Swap(this->values_valid, list->values_valid);
 	Swap(this->sorter, list->sorter);
 	Swap(this->sorter_type, list->sorter_type);
 	Swap(this->sort_ascending, list->sort_ascending);
@@ -590,40 +537,28 @@ void ScriptList::RemoveAboveValue(int64 value)
 {
 	this->modifications++;
 
-	for (ScriptListMap::iterator next_iter, iter = this->items.begin(); iter != this->items.end(); iter = next_iter) {
-		next_iter = iter; next_iter++;
-		if ((*iter).second > value) this->RemoveItem((*iter).first);
-	}
+	if (value < INT64_MAX) this->RemoveValueRange(value + 1, INT64_MAX);
 }
 
 void ScriptList::RemoveBelowValue(int64 value)
 {
 	this->modifications++;
 
-	for (ScriptListMap::iterator next_iter, iter = this->items.begin(); iter != this->items.end(); iter = next_iter) {
-		next_iter = iter; next_iter++;
-		if ((*iter).second < value) this->RemoveItem((*iter).first);
-	}
+	if (value > INT64_MIN) this->RemoveValueRange(INT64_MIN, value - 1);
 }
 
 void ScriptList::RemoveBetweenValue(int64 start, int64 end)
 {
 	this->modifications++;
 
-	for (ScriptListMap::iterator next_iter, iter = this->items.begin(); iter != this->items.end(); iter = next_iter) {
-		next_iter = iter; next_iter++;
-		if ((*iter).second > start && (*iter).second < end) this->RemoveItem((*iter).first);
-	}
+	if (start < end) this->RemoveValueRange(start + 1, end - 1);
 }
 
 void ScriptList::RemoveValue(int64 value)
 {
 	this->modifications++;
 
-	for (ScriptListMap::iterator next_iter, iter = this->items.begin(); iter != this->items.end(); iter = next_iter) {
-		next_iter = iter; next_iter++;
-		if ((*iter).second == value) this->RemoveItem((*iter).first);
-	}
+	this->RemoveValueRange(value, value);
 }
 
 void ScriptList::RemoveTop(int32 count)
@@ -640,24 +575,15 @@ void ScriptList::RemoveTop(int32 count)
 	switch (this->sorter_type) {
 		default: NOT_REACHED();
 		case SORT_BY_VALUE:
-			for (ScriptListBucket::iterator iter = this->buckets.begin(); iter != this->buckets.end(); iter = this->buckets.begin()) {
-				ScriptItemList *items = &(*iter).second;
-				size_t size = items->size();
-				for (ScriptItemList::iterator iter = items->begin(); iter != items->end(); iter = items->begin()) {
-					if (--count < 0) return;
-					this->RemoveItem(*iter);
-					/* When the last item is removed from the bucket, the bucket itself is removed.
-					 * This means that the iterators can be invalid after a call to RemoveItem.
-					 */
-					if (--size == 0) break;
-				}
+			this->UpdateValues();
+			for (; count > 0 && !this->values.empty(); count--) {
+				this->RemoveItem(this->values.begin()->second);
 			}
 			break;
 
 		case SORT_BY_ITEM:
-			for (ScriptListMap::iterator iter = this->items.begin(); iter != this->items.end(); iter = this->items.begin()) {
-				if (--count < 0) return;
-				this->RemoveItem((*iter).first);
+			for (; count > 0 && !this->items.empty(); count--) {
+				this->RemoveItem(this->items.begin()->first);
 			}
 			break;
 	}
@@ -677,24 +603,19 @@ void ScriptList::RemoveBottom(int32 count)
 	switch (this->sorter_type) {
 		default: NOT_REACHED();
 		case SORT_BY_VALUE:
-			for (ScriptListBucket::reverse_iterator iter = this->buckets.rbegin(); iter != this->buckets.rend(); iter = this->buckets.rbegin()) {
-				ScriptItemList *items = &(*iter).second;
-				size_t size = items->size();
-				for (ScriptItemList::reverse_iterator iter = items->rbegin(); iter != items->rend(); iter = items->rbegin()) {
-					if (--count < 0) return;
-					this->RemoveItem(*iter);
-					/* When the last item is removed from the bucket, the bucket itself is removed.
-					 * This means that the iterators can be invalid after a call to RemoveItem.
-					 */
-					if (--size == 0) break;
-				}
+			this->UpdateValues();
+			for (; count > 0 && !this->values.empty(); count--) {
+				ScriptListValueSet::iterator iter = this->values.end();
+				--iter;
+				this->RemoveItem(iter->second);
 			}
 			break;
 
 		case SORT_BY_ITEM:
-			for (ScriptListMap::reverse_iterator iter = this->items.rbegin(); iter != this->items.rend(); iter = this->items.rbegin()) {
-				if (--count < 0) return;
-				this->RemoveItem((*iter).first);
+			for (; count > 0 && !this->items.empty(); count--) {
+				ScriptListMap::iterator iter = this->items.end();
+				--iter;
+				this->RemoveItem(iter->first);
 			}
 			break;
 	}
@@ -718,40 +639,30 @@ void ScriptList::KeepAboveValue(int64 value)
 {
 	this->modifications++;
 
-	for (ScriptListMap::iterator next_iter, iter = this->items.begin(); iter != this->items.end(); iter = next_iter) {
-		next_iter = iter; next_iter++;
-		if ((*iter).second <= value) this->RemoveItem((*iter).first);
-	}
+	this->RemoveValueRange(INT64_MIN, value);
 }
 
 void ScriptList::KeepBelowValue(int64 value)
 {
 	this->modifications++;
 
-	for (ScriptListMap::iterator next_iter, iter = this->items.begin(); iter != this->items.end(); iter = next_iter) {
-		next_iter = iter; next_iter++;
-		if ((*iter).second >= value) this->RemoveItem((*iter).first);
-	}
+	this->RemoveValueRange(value, INT64_MAX);
 }
 
 void ScriptList::KeepBetweenValue(int64 start, int64 end)
 {
 	this->modifications++;
 
-	for (ScriptListMap::iterator next_iter, iter = this->items.begin(); iter != this->items.end(); iter = next_iter) {
-		next_iter = iter; next_iter++;
-		if ((*iter).second <= start || (*iter).second >= end) this->RemoveItem((*iter).first);
-	}
+	this->RemoveValueRange(INT64_MIN, start);
+	this->RemoveValueRange(end, INT64_MAX);
 }
 
 void ScriptList::KeepValue(int64 value)
 {
 	this->modifications++;
 
-	for (ScriptListMap::iterator next_iter, iter = this->items.begin(); iter != this->items.end(); iter = next_iter) {
-		next_iter = iter; next_iter++;
-		if ((*iter).second != value) this->RemoveItem((*iter).first);
-	}
+	if (value > INT64_MIN) this->RemoveValueRange(INT64_MIN, value - 1);
+	if (value < INT64_MAX) this->RemoveValueRange(value + 1, INT64_MAX);
 }
 
 void ScriptList::KeepTop(int32 count)
@@ -866,10 +777,27 @@ SQInteger ScriptList::Valuate(HSQUIRRELVM vm)
 	bool backup_allow = ScriptObject::GetAllowDoCommand();
 	ScriptObject::SetAllowDoCommand(false);
 
+	/* Valuators which are API functions only taking the item can be called without going through Squirrel. */
+	Squirrel::DirectValuatorProc *direct_proc = nullptr;
+	const void *direct_function = nullptr;
+	if (nparam == 1 && !Squirrel::GetDirectValuator(vm, 2, &direct_proc, &direct_function)) direct_proc = nullptr;
+
 	/* Push the function to call */
 	sq_push(vm, 2);
 
+	/* Unless the list is being iterated by value, drop the value index and rebuild it in one go when it is next needed. */
+	if (this->sorter->IsEnd()) {
+		this->values.clear();
+		this->values_valid = false;
+	}
+
 	for (ScriptListMap::iterator iter = this->items.begin(); iter != this->items.end(); iter++) {
+		if (direct_proc != nullptr) {
+			this->SetValue((*iter).first, direct_proc(direct_function, (*iter).first));
+			Squirrel::DecreaseOps(vm, 5);
+			continue;
+		}
+
 		/* Check for changing of items. */
 		int previous_modification_count = this->modifications;
 
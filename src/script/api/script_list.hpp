@@ -12,8 +12,10 @@
 #define SCRIPT_LIST_HPP
 
 #include "script_object.hpp"
-#include <map>
-#include <set>
+#include "../../3rdparty/cpp-btree/btree_map.h"
+#include "../../3rdparty/cpp-btree/btree_set.h"
+#include <utility>
+#include <vector>
 
 class ScriptListSorter;
 
@@ -22,6 +24,7 @@ class ScriptListSorter;
  * @api ai game
  */
 class ScriptList : public ScriptObject {
+	friend class ScriptListSorter;
 public:
 	/** Type of sorter */
 	enum SorterType {
@@ -40,14 +43,17 @@ private:
 	bool sort_ascending;          ///< Whether to sort ascending or descending
 	bool initialized;             ///< Whether an iteration has been started
 	int modifications;            ///< Number of modification that has been done. To prevent changing data while valuating.
+	bool values_valid;            ///< Whether #values is up to date with #items
+
+	void UpdateValues();
+	void RemoveValueRange(int64 start, int64 end);
 
 public:
-	typedef std::set<int64> ScriptItemList;                   ///< The list of items inside the bucket
-	typedef std::map<int64, ScriptItemList> ScriptListBucket; ///< The bucket list per value
-	typedef std::map<int64, int64> ScriptListMap;             ///< List per item
+	typedef btree::btree_map<int64, int64> ScriptListMap;                  ///< List per item
+	typedef btree::btree_set<std::pair<int64, int64>> ScriptListValueSet; ///< Value and item pairs, sorted by value and then by item
 
 	ScriptListMap items;           ///< The items in the list
-	ScriptListBucket buckets;      ///< The items in the list, sorted by value
+	ScriptListValueSet values;     ///< The items in the list, sorted by value. Only valid if #values_valid, rebuilt when required.
 
 	ScriptList();
 	~ScriptList();
@@ -15,6 +15,8 @@
 #include "../../depot_map.h"
 #include "../../vehicle_base.h"
 #include "../../train.h"
+#include "../../group.h"
+#include "../../vehiclelist.h"
 
 #include "../../safeguards.h"
 
@@ -25,22 +27,39 @@ ScriptVehicleList::ScriptVehicleList()
 	}
 }
 
+/**
+ * Call a function for each primary vehicle of a company, or of all companies for a deity script.
+ * @param company The script company.
+ * @param type The vehicle type, or VEH_INVALID for all types.
+ * @param func Function to call with each vehicle.
+ */
+template <typename F>
+static void IterateScriptPrimaryVehicles(CompanyID company, VehicleType type, F func)
+{
+	for (VehicleType vt = VEH_BEGIN; vt < VEH_COMPANY_END; vt++) {
+		if (type != VEH_INVALID && vt != type) continue;
+		if (company == OWNER_DEITY) {
+			IteratePrimaryVehicles(vt, func);
+		} else {
+			IteratePrimaryVehicles(company, vt, func);
+		}
+	}
+}
+
 ScriptVehicleList_Station::ScriptVehicleList_Station(StationID station_id)
 {
 	if (!ScriptBaseStation::IsValidBaseStation(station_id)) return;
 
-	for (const Vehicle *v : Vehicle::Iterate()) {
-		if ((v->owner == ScriptObject::GetCompany() || ScriptObject::GetCompany() == OWNER_DEITY) && v->IsPrimaryVehicle()) {
-			const Order *order;
-
-			FOR_VEHICLE_ORDERS(v, order) {
-				if ((order->IsType(OT_GOTO_STATION) || order->IsType(OT_GOTO_WAYPOINT)) && order->GetDestination() == station_id) {
-					this->AddItem(v->index);
-					break;
-				}
+	IterateScriptPrimaryVehicles(ScriptObject::GetCompany(), VEH_INVALID, [&](const Vehicle *v) {
+		const Order *order;
+
+		FOR_VEHICLE_ORDERS(v, order) {
+			if ((order->IsType(OT_GOTO_STATION) || order->IsType(OT_GOTO_WAYPOINT)) && order->GetDestination() == station_id) {
+				this->AddItem(v->index);
+				break;
 			}
 		}
-	}
+	});
 }
 
 ScriptVehicleList_Depot::ScriptVehicleList_Depot(TileIndex tile)
@@ -79,18 +98,16 @@ ScriptVehicleList_Depot::ScriptVehicleList_Depot(TileIndex tile)
 			return;
 	}
 
-	for (const Vehicle *v : Vehicle::Iterate()) {
-		if ((v->owner == ScriptObject::GetCompany() || ScriptObject::GetCompany() == OWNER_DEITY) && v->IsPrimaryVehicle() && v->type == type) {
-			const Order *order;
-
-			FOR_VEHICLE_ORDERS(v, order) {
-				if (order->IsType(OT_GOTO_DEPOT) && order->GetDestination() == dest) {
-					this->AddItem(v->index);
-					break;
-				}
+	IterateScriptPrimaryVehicles(ScriptObject::GetCompany(), type, [&](const Vehicle *v) {
+		const Order *order;
+
+		FOR_VEHICLE_ORDERS(v, order) {
+			if (order->IsType(OT_GOTO_DEPOT) && order->GetDestination() == dest) {
+				this->AddItem(v->index);
+				break;
 			}
 		}
-	}
+	});
 }
 
 ScriptVehicleList_SharedOrders::ScriptVehicleList_SharedOrders(VehicleID vehicle_id)
@@ -106,20 +123,17 @@ ScriptVehicleList_Group::ScriptVehicleList_Group(GroupID group_id)
 {
 	if (!ScriptGroup::IsValidGroup((ScriptGroup::GroupID)group_id)) return;
 
-	for (const Vehicle *v : Vehicle::Iterate()) {
-		if (v->owner == ScriptObject::GetCompany() && v->IsPrimaryVehicle()) {
-			if (v->group_id == group_id) this->AddItem(v->index);
-		}
-	}
+	const ::Group *g = ::Group::Get(group_id);
+	IterateGroupPrimaryVehicles(ScriptObject::GetCompany(), g->vehicle_type, group_id, [&](const Vehicle *v) {
+		this->AddItem(v->index);
+	});
 }
 
 ScriptVehicleList_DefaultGroup::ScriptVehicleList_DefaultGroup(ScriptVehicle::VehicleType vehicle_type)
 {
 	if (vehicle_type < ScriptVehicle::VT_RAIL || vehicle_type > ScriptVehicle::VT_AIR) return;
 
-	for (const Vehicle *v : Vehicle::Iterate()) {
-		if (v->owner == ScriptObject::GetCompany() && v->IsPrimaryVehicle()) {
-			if (v->type == (::VehicleType)vehicle_type && v->group_id == ScriptGroup::GROUP_DEFAULT) this->AddItem(v->index);
-		}
-	}
+	IterateGroupPrimaryVehicles(ScriptObject::GetCompany(), (::VehicleType)vehicle_type, ::DEFAULT_GROUP, [&](const Vehicle *v) {
+		this->AddItem(v->index);
+	});
 }
@@ -1334,6 +1334,7 @@ public:
 		WID_FRW_RATE_GAMELOOP                        = ::WID_FRW_RATE_GAMELOOP,
 		WID_FRW_RATE_DRAWING                         = ::WID_FRW_RATE_DRAWING,
 		WID_FRW_RATE_FACTOR                          = ::WID_FRW_RATE_FACTOR,
+		WID_FRW_INFO_DIRTY_BLOCKS                    = ::WID_FRW_INFO_DIRTY_BLOCKS,
 		WID_FRW_INFO_DATA_POINTS                     = ::WID_FRW_INFO_DATA_POINTS,
 		WID_FRW_TIMES_NAMES                          = ::WID_FRW_TIMES_NAMES,
 		WID_FRW_TIMES_CURRENT                        = ::WID_FRW_TIMES_CURRENT,
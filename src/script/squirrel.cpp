@@ -19,6 +19,8 @@
 #include <sqstdaux.h>
 #include <../squirrel/sqpcheader.h>
 #include <../squirrel/sqvm.h>
+#include <../squirrel/sqclosure.h>
+#include <../squirrel/squserdata.h>
 #include "../core/alloc_func.hpp"
 
 #include "../safeguards.h"
@@ -727,6 +729,30 @@ void Squirrel::InsertResult(int result)
 	vm->DecreaseOps(ops);
 }
 
+/* static */ bool Squirrel::GetDirectValuator(HSQUIRRELVM vm, SQInteger index, DirectValuatorProc **proc, const void **function_proc)
+{
+	const SQObjectPtr &obj = stack_get(vm, index);
+	if (sq_type(obj) != OT_NATIVECLOSURE) return false;
+
+	const SQNativeClosure *closure = _nativeclosure(obj);
+	const std::map<SQFUNCTION, DirectValuatorProc *> &direct_valuators = ((const Squirrel *)sq_getforeignptr(vm))->direct_valuators;
+	auto iter = direct_valuators.find(closure->_function);
+	if (iter == direct_valuators.end()) return false;
+
+	/* The function pointer is the only free variable. */
+	if (closure->_outervalues.size() != 1 || sq_type(closure->_outervalues[0]) != OT_USERDATA) return false;
+
+	/* Parameter checks must pass exactly like they would for a call from Squirrel with the root table and an integer. */
+	if (closure->_nparamscheck > 0 && closure->_nparamscheck != 2) return false;
+	if (closure->_nparamscheck < 0 && -closure->_nparamscheck > 2) return false;
+	if (closure->_typecheck.size() > 0 && closure->_typecheck[0] != -1 && !(closure->_typecheck[0] & OT_TABLE)) return false;
+	if (closure->_typecheck.size() > 1 && closure->_typecheck[1] != -1 && !(closure->_typecheck[1] & OT_INTEGER)) return false;
+
+	*proc = iter->second;
+	*function_proc = _userdataval(closure->_outervalues[0]);
+	return true;
+}
+
 bool Squirrel::IsSuspended()
 {
 	return this->vm->_suspended != 0;
@@ -11,6 +11,7 @@
 #define SQUIRREL_HPP
 
 #include <squirrel.h>
+#include <map>
 
 /** The type of script we're working with, i.e. for who is it? */
 enum ScriptType {
@@ -245,6 +246,32 @@ public:
 	 */
 	static void DecreaseOps(HSQUIRRELVM vm, int amount);
 
+	/** Function to call an API function directly with a single integer parameter, see SQConvert::DirectValuatorT. */
+	typedef SQInteger (DirectValuatorProc)(const void *function_proc, SQInteger item);
+
+private:
+	std::map<SQFUNCTION, DirectValuatorProc *> direct_valuators; ///< Callbacks of the native closures of the registered API which can be called directly.
+
+public:
+	/**
+	 * Register a way to call the native closures with the given callback directly from C++.
+	 * Must only be called while registering the API, the table is only read afterwards.
+	 * @param callback The callback of the native closures.
+	 * @param proc The function calling the API function of such a closure.
+	 */
+	void RegisterDirectValuator(SQFUNCTION callback, DirectValuatorProc *proc) { this->direct_valuators[callback] = proc; }
+
+	/**
+	 * Check whether the object on the stack is a native closure which can be called directly from C++
+	 * with a single integer parameter, with the same result as calling it via Squirrel.
+	 * @param vm The VM.
+	 * @param index The index of the closure on the stack.
+	 * @param[out] proc The function to call.
+	 * @param[out] function_proc The API function to pass to \a proc.
+	 * @return True if the closure can be called directly.
+	 */
+	static bool GetDirectValuator(HSQUIRRELVM vm, SQInteger index, DirectValuatorProc **proc, const void **function_proc);
+
 	/**
 	 * Did the squirrel code suspend or return normally.
 	 * @return True if the function suspended.
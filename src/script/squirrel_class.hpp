@@ -67,6 +67,7 @@ public:
 	{
 		using namespace SQConvert;
 		engine->AddMethod(function_name, DefSQStaticCallback<CL, Func>, 0, nullptr, &function_proc, sizeof(function_proc));
+		if (IsDirectValuatorT<Func>::Yes) engine->RegisterDirectValuator(DefSQStaticCallback<CL, Func>, DirectValuatorT<Func>::Call);
 	}
 
 	/**
@@ -90,6 +91,7 @@ public:
 	{
 		using namespace SQConvert;
 		engine->AddMethod(function_name, DefSQStaticCallback<CL, Func>, nparam, params, &function_proc, sizeof(function_proc));
+		if (IsDirectValuatorT<Func>::Yes) engine->RegisterDirectValuator(DefSQStaticCallback<CL, Func>, DirectValuatorT<Func>::Call);
 	}
 
 	template <typename Var>
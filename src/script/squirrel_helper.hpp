@@ -15,6 +15,7 @@
 #include "../economy_type.h"
 #include "../string_func.h"
 #include "squirrel_helper_type.hpp"
+#include <type_traits>
 
 template <class CL, ScriptType ST> const char *GetClassName();
 
@@ -906,6 +907,41 @@ namespace SQConvert {
 		}
 	}
 
+	/**
+	 * Whether a static API function can be called directly from C++, for example as valuator,
+	 *  instead of via Squirrel. Only functions with a single integer or enum parameter
+	 *  and an integer, enum, bool or Money return value are supported.
+	 */
+	template <typename Tfunc> struct IsDirectValuatorT : YesT<false> {};
+	template <typename Tretval, typename Targ1> struct IsDirectValuatorT<Tretval (*)(Targ1)> : YesT<
+			(std::is_integral<Targ1>::value || std::is_enum<Targ1>::value) && !std::is_same<Targ1, bool>::value &&
+			(std::is_integral<Tretval>::value || std::is_enum<Tretval>::value || std::is_same<Tretval, Money>::value)> {};
+
+	/** Convert the return value of a directly called API function like Return does. Unsigned values, bools and enums are returned as int32. */
+	template <typename T> inline SQInteger DirectValuatorResult(T res) { return (std::is_unsigned<T>::value || std::is_enum<T>::value) ? (SQInteger)(int32)res : (SQInteger)res; }
+	/** Convert the Money return value of a directly called API function like Return does, as int64. */
+	template <> inline SQInteger DirectValuatorResult<Money>(Money res) { return (int64)res; }
+
+	/**
+	 * Helper to call a static API function directly from C++. The parameter and the
+	 *  return value are converted the same way GetParam and Return would.
+	 */
+	template <typename Tfunc, bool Tusable = IsDirectValuatorT<Tfunc>::Yes>
+	struct DirectValuatorT {
+		static SQInteger Call(const void *function_proc, SQInteger item) { NOT_REACHED(); }
+	};
+
+	/**
+	 * Helper to call a static API function with one parameter directly from C++.
+	 */
+	template <typename Tretval, typename Targ1>
+	struct DirectValuatorT<Tretval (*)(Targ1), true> {
+		static SQInteger Call(const void *function_proc, SQInteger item)
+		{
+			return DirectValuatorResult<Tretval>((*(Tretval (* const *)(Targ1))function_proc)((Targ1)item));
+		}
+	};
+
 } // namespace SQConvert
 
 #endif /* SQUIRREL_HELPER_HPP */
@@ -479,6 +479,7 @@ struct YAPFSettings {
 	uint32 rail_shorter_platform_per_tile_penalty; ///< penalty for shorter station platform than train (per tile)
 	uint32 ship_curve45_penalty;                   ///< penalty for 45-deg curve for ships
 	uint32 ship_curve90_penalty;                   ///< penalty for 90-deg curve for ships
+	bool   prefetch_road_ship_paths;               ///< solve the path beyond the end of road vehicle and ship path caches in the background between ticks
 };
 
 /** Settings related to all pathfinders. */
@@ -505,10 +505,12 @@ static Track ChooseShipTrack(Ship *v, TileIndex tile, DiagDirection enterdir, Tr
 	} else {
 		/* Attempt to follow cached path. */
 		if (!v->path.empty()) {
-			track = TrackdirToTrack(v->path.front());
+			Trackdir trackdir = v->path.front();
+			track = TrackdirToTrack(trackdir);
 
 			if (HasBit(tracks, track)) {
 				v->path.pop_front();
+				if (v->path.size() == YAPF_SHIP_PATH_CACHE_PREFETCH) YapfQueueShipPathPrefetch(v, tile, trackdir);
 				/* HandlePathfindResult() is not called here because this is not a new pathfinder result. */
 				return track;
 			}
@@ -34,10 +34,10 @@ static SignalDependencyMap _signal_dependencies;
 static void MarkDependencidesForUpdate(SignalReference sig);
 
 /** these are the maximums used for updating signal blocks */
-static const uint SIG_TBU_SIZE    =  64; ///< number of signals entering to block
-static const uint SIG_TBD_SIZE    = 256; ///< number of intersections - open nodes in current block
-static const uint SIG_GLOB_SIZE   = 128; ///< number of open blocks (block can be opened more times until detected)
-static const uint SIG_GLOB_UPDATE =  64; ///< how many items need to be in _globset to force update
+static const uint SIG_TBU_SIZE    =  256; ///< number of signals entering to block
+static const uint SIG_TBD_SIZE    = 1024; ///< number of intersections - open nodes in current block
+static const uint SIG_GLOB_SIZE   =  512; ///< number of open blocks (block can be opened more times until detected)
+static const uint SIG_GLOB_UPDATE =  256; ///< how many items need to be in _globset to force update
 
 assert_compile(SIG_GLOB_UPDATE <= SIG_GLOB_SIZE);
 
@@ -60,11 +60,16 @@ static const TrackdirBits _enterdir_to_trackdirbits[DIAGDIR_END] = {
 /**
  * Set containing 'items' items of 'tile and Tdir'
  * No tree structure is used because it would cause
- * slowdowns in most usual cases
+ * slowdowns in most usual cases.
+ * Instead a small table counts the items per hash bucket, so that looking up
+ * an item which is not in the set, which is by far the most common case when
+ * exploring large signal blocks, does not have to scan the whole set.
  */
 template <typename Tdir, uint items>
 struct SmallSet {
 private:
+	static const uint FILTER_SIZE = 256; ///< number of hash buckets, must be a power of 2
+
 	uint n;           // actual number of units
 	bool overflowed;  // did we try to overflow the set?
 	const char *name; // name, used for debugging purposes...
@@ -75,15 +80,32 @@ private:
 		Tdir dir;
 	} data[items];
 
+	uint16 filter[FILTER_SIZE]; ///< number of items in the set per hash bucket
+
+	/**
+	 * Get the hash bucket of an item
+	 * @param tile tile
+	 * @param dir dir
+	 * @return index into filter
+	 */
+	static inline uint FilterSlot(TileIndex tile, Tdir dir)
+	{
+		return ((tile * 0x9E3779B1u) >> 24 ^ (uint)dir) & (FILTER_SIZE - 1);
+	}
+
 public:
 	/** Constructor - just set default values and 'name' */
-	SmallSet(const char *name) : n(0), overflowed(false), name(name) { }
+	SmallSet(const char *name) : n(0), overflowed(false), name(name)
+	{
+		MemSetT(this->filter, 0, FILTER_SIZE);
+	}
 
 	/** Reset variables to default values */
 	void Reset()
 	{
 		this->n = 0;
 		this->overflowed = false;
+		MemSetT(this->filter, 0, FILTER_SIZE);
 	}
 
 	/**
@@ -131,9 +153,13 @@ public:
 	 */
 	bool Remove(TileIndex tile, Tdir dir)
 	{
+		const uint slot = FilterSlot(tile, dir);
+		if (this->filter[slot] == 0) return false;
+
 		for (uint i = 0; i < this->n; i++) {
 			if (this->data[i].tile == tile && this->data[i].dir == dir) {
 				this->data[i] = this->data[--this->n];
+				this->filter[slot]--;
 				return true;
 			}
 		}
@@ -149,6 +175,8 @@ public:
 	 */
 	bool IsIn(TileIndex tile, Tdir dir)
 	{
+		if (this->filter[FilterSlot(tile, dir)] == 0) return false;
+
 		for (uint i = 0; i < this->n; i++) {
 			if (this->data[i].tile == tile && this->data[i].dir == dir) return true;
 		}
@@ -174,6 +202,7 @@ public:
 		this->data[this->n].tile = tile;
 		this->data[this->n].dir = dir;
 		this->n++;
+		this->filter[FilterSlot(tile, dir)]++;
 
 		return true;
 	}
@@ -191,6 +220,7 @@ public:
 		this->n--;
 		*tile = this->data[this->n].tile;
 		*dir = this->data[this->n].dir;
+		this->filter[FilterSlot(*tile, *dir)]--;
 
 		return true;
 	}
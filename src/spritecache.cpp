@@ -19,6 +19,8 @@
 #include "core/math_func.hpp"
 #include "core/mem_func.hpp"
 #include "scope_info.h"
+#include "thread.h"
+#include "viewport_func.h"
 
 #include "table/sprites.h"
 #include "table/strings.h"
@@ -28,6 +30,9 @@
 
 #include <vector>
 #include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
 
 #include "safeguards.h"
 
@@ -448,6 +453,30 @@ static void *ReadRecolourSprite(uint16 file_slot, uint num)
 	return dest;
 }
 
+/**
+ * Load the zoom levels of a sprite, preferring 32bpp sprites when the blitter supports these.
+ * @param[out] sprite The sprites to fill with data.
+ * @param file_slot File slot of the sprite.
+ * @param file_pos Position of the sprite in the file.
+ * @param sprite_type Type of the sprite.
+ * @param container_ver Container version of the GRF the sprite is from.
+ * @return Bit mask of the zoom levels successfully loaded or 0 if no sprite could be loaded.
+ */
+static uint8 LoadSpriteZoomLevels(SpriteLoader::Sprite *sprite, uint file_slot, size_t file_pos, SpriteType sprite_type, byte container_ver)
+{
+	uint8 sprite_avail = 0;
+
+	SpriteLoaderGrf sprite_loader(container_ver);
+	if (sprite_type != ST_MAPGEN && BlitterFactory::GetCurrentBlitter()->GetScreenDepth() == 32) {
+		/* Try for 32bpp sprites first. */
+		sprite_avail = sprite_loader.LoadSprite(sprite, file_slot, file_pos, sprite_type, true);
+	}
+	if (sprite_avail == 0) {
+		sprite_avail = sprite_loader.LoadSprite(sprite, file_slot, file_pos, sprite_type, false);
+	}
+	return sprite_avail;
+}
+
 /**
  * Read a sprite from disk.
  * @param sc          Location of sprite.
@@ -470,17 +499,9 @@ static void *ReadSprite(const SpriteCache *sc, SpriteID id, SpriteType sprite_ty
 	DEBUG(sprite, 9, "Load sprite %d", id);
 
 	SpriteLoader::Sprite sprite[ZOOM_LVL_COUNT];
-	uint8 sprite_avail = 0;
 	sprite[ZOOM_LVL_NORMAL].type = sprite_type;
 
-	SpriteLoaderGrf sprite_loader(sc->container_ver);
-	if (sprite_type != ST_MAPGEN && BlitterFactory::GetCurrentBlitter()->GetScreenDepth() == 32) {
-		/* Try for 32bpp sprites first. */
-		sprite_avail = sprite_loader.LoadSprite(sprite, file_slot, file_pos, sprite_type, true);
-	}
-	if (sprite_avail == 0) {
-		sprite_avail = sprite_loader.LoadSprite(sprite, file_slot, file_pos, sprite_type, false);
-	}
+	uint8 sprite_avail = LoadSpriteZoomLevels(sprite, file_slot, file_pos, sprite_type, sc->container_ver);
 
 	if (sprite_avail == 0) {
 		if (sprite_type == ST_MAPGEN) return nullptr;
@@ -535,7 +556,7 @@ static void *ReadSprite(const SpriteCache *sc, SpriteID id, SpriteType sprite_ty
 
 
 /** Map from sprite numbers to position in the GRF file. */
-static btree::btree_map<uint32, size_t> _grf_sprite_offsets;
+static GRFSpriteOffsets _grf_sprite_offsets;
 
 /**
  * Get the file offset for a specific sprite in the sprite section of a GRF.
@@ -576,6 +597,57 @@ void ReadGRFSpriteOffsets(byte container_version)
 	}
 }
 
+/**
+ * Parse the sprite section of a GRF without using the file slots, so it can be done on any thread.
+ * @param f The GRF file, positioned at the start of the GRF.
+ * @param[out] offsets Map from sprite numbers to position in the file.
+ * @return True if the GRF has container version 2 and its sprite section was read completely.
+ */
+bool ReadGRFSpriteOffsetsFromFile(FILE *f, GRFSpriteOffsets &offsets)
+{
+	extern const byte _grf_cont_v2_sig[8];
+
+	auto read_dword = [&](uint32 &value) -> bool {
+		byte data[4];
+		if (fread(data, 1, sizeof(data), f) != sizeof(data)) return false;
+		value = data[0] | (data[1] << 8) | (data[2] << 16) | ((uint32)data[3] << 24);
+		return true;
+	};
+
+	/* Container version 1 has no sprite section. */
+	byte header[10];
+	if (fread(header, 1, sizeof(header), f) != sizeof(header)) return false;
+	if (header[0] != 0 || header[1] != 0 || MemCmpT(header + 2, _grf_cont_v2_sig, 8) != 0) return false;
+
+	/* Seek to sprite section of the GRF. */
+	uint32 data_offset;
+	if (!read_dword(data_offset) || fseek(f, data_offset, SEEK_CUR) < 0) return false;
+
+	uint32 id, prev_id = 0;
+	for (;;) {
+		if (!read_dword(id)) return false;
+		if (id == 0) return true;
+
+		long pos = ftell(f);
+		if (pos < 0) return false;
+		if (id != prev_id) offsets[id] = pos - 4;
+		prev_id = id;
+
+		uint32 size;
+		if (!read_dword(size) || fseek(f, size, SEEK_CUR) < 0) return false;
+	}
+}
+
+/**
+ * Use sprite section offsets read in advance by #ReadGRFSpriteOffsetsFromFile, instead of #ReadGRFSpriteOffsets.
+ * The caller has to skip the sprite section offset of the GRF.
+ * @param offsets The sprite section offsets of the GRF currently processed.
+ */
+void SetGRFSpriteOffsets(const GRFSpriteOffsets &offsets)
+{
+	_grf_sprite_offsets = offsets;
+}
+
 
 /**
  * Load a real or recolour sprite.
@@ -770,6 +842,291 @@ static void *AllocSprite(size_t mem_req)
 	return _last_sprite_allocation.GetPtr();
 }
 
+/** A sprite to be loaded by the background sprite loaders. */
+struct AsyncSpriteLoadJob {
+	SpriteID sprite;     ///< Sprite to load.
+	size_t file_pos;     ///< Position of the sprite in its file.
+	uint32 id;           ///< GRF local ID of the sprite.
+	uint16 file_slot;    ///< File slot of the sprite.
+	byte container_ver;  ///< Container version of the GRF the sprite is from.
+};
+
+/** A sprite loaded by the background sprite loaders. */
+struct AsyncSpriteLoadResult {
+	SpriteID sprite;     ///< Loaded sprite.
+	void *data;          ///< Encoded sprite allocated with malloc, or nullptr if the sprite has to be loaded by the main thread instead.
+	uint32 size;         ///< Size of the encoded sprite.
+	std::vector<SpriteLoaderMessage> messages; ///< Debug messages of loading the sprite, to print on the main thread.
+};
+
+/**
+ * Threads loading, resizing and encoding sprites in the background.
+ * While a sprite is being loaded, viewports draw a placeholder instead, and redraw the area when the sprite is available.
+ */
+struct AsyncSpriteLoaders {
+	std::mutex lock;                            ///< Lock for the members below.
+	std::condition_variable work_available;     ///< Signalled when jobs are queued or the threads have to stop.
+	std::condition_variable work_done;          ///< Signalled when a thread finished a job.
+	std::vector<std::thread> threads;           ///< The loader threads.
+	std::deque<AsyncSpriteLoadJob> jobs;        ///< Jobs waiting for a thread.
+	std::vector<AsyncSpriteLoadResult> results; ///< Results waiting for the main thread.
+	uint busy = 0;                              ///< Number of jobs being processed by threads.
+	bool stop = false;                          ///< Whether the threads have to stop.
+	bool started = false;                       ///< Whether starting the threads has been attempted.
+};
+
+static AsyncSpriteLoaders _async_sprite_loaders;
+static btree::btree_map<SpriteID, Rect> _async_sprite_requests; ///< Sprites being loaded in the background, with the viewport area to redraw when done.
+static bool _async_sprite_area_active = false; ///< Whether a viewport is being drawn to the screen, see #BeginAsyncSpriteLoading.
+static Rect _async_sprite_area;                ///< Viewport area being drawn to the screen.
+static void *_async_sprite_placeholder = nullptr; ///< Encoded empty sprite to draw while a sprite is loaded.
+
+static thread_local void *_async_sprite_allocation = nullptr; ///< Last allocation of #AsyncSpriteAlloc.
+static thread_local size_t _async_sprite_allocation_size = 0;  ///< Size of #_async_sprite_allocation.
+
+/**
+ * Sprite allocator for use outside of the main thread.
+ * @param mem_req Size of the memory to allocate.
+ * @return The allocated memory.
+ */
+static void *AsyncSpriteAlloc(size_t mem_req)
+{
+	assert(_async_sprite_allocation == nullptr);
+	_async_sprite_allocation = MallocT<byte>(mem_req);
+	_async_sprite_allocation_size = mem_req;
+	return _async_sprite_allocation;
+}
+
+/**
+ * Load, resize and encode a sprite on a background loader thread.
+ * @param job The sprite to load.
+ * @return The result, without data if the sprite has to be loaded by the main thread instead.
+ */
+static AsyncSpriteLoadResult LoadAsyncSprite(const AsyncSpriteLoadJob &job)
+{
+	AsyncSpriteLoadResult result = { job.sprite, nullptr, 0, {} };
+
+	_grf_corrupt_sprite_in_thread = false;
+	_grf_sprite_loader_messages.clear();
+	SpriteLoader::Sprite sprite[ZOOM_LVL_COUNT];
+	sprite[ZOOM_LVL_NORMAL].type = ST_NORMAL;
+	uint8 sprite_avail = LoadSpriteZoomLevels(sprite, job.file_slot, job.file_pos, ST_NORMAL, job.container_ver);
+	if (sprite_avail == 0 || _grf_corrupt_sprite_in_thread) return result;
+	if (!ResizeSprites(sprite, sprite_avail, job.file_slot, job.id)) return result;
+
+	BlitterFactory::GetCurrentBlitter()->Encode(sprite, AsyncSpriteAlloc);
+	result.messages.swap(_grf_sprite_loader_messages);
+	result.data = _async_sprite_allocation;
+	result.size = (uint32)_async_sprite_allocation_size;
+	_async_sprite_allocation = nullptr;
+	return result;
+}
+
+/** Main loop of the background sprite loader threads. */
+static void AsyncSpriteLoaderThread()
+{
+	AsyncSpriteLoaders &loaders = _async_sprite_loaders;
+	std::unique_lock<std::mutex> lock(loaders.lock);
+	for (;;) {
+		loaders.work_available.wait(lock, [&]() { return loaders.stop || !loaders.jobs.empty(); });
+		if (loaders.stop) return;
+
+		AsyncSpriteLoadJob job = loaders.jobs.front();
+		loaders.jobs.pop_front();
+		loaders.busy++;
+		lock.unlock();
+
+		AsyncSpriteLoadResult result = LoadAsyncSprite(job);
+
+		lock.lock();
+		loaders.results.push_back(std::move(result));
+		loaders.busy--;
+		loaders.work_done.notify_all();
+	}
+}
+
+/**
+ * Start the background sprite loader threads, if not done already.
+ * @return Whether there are background sprite loader threads.
+ */
+static bool StartAsyncSpriteLoaders()
+{
+	AsyncSpriteLoaders &loaders = _async_sprite_loaders;
+	if (!loaders.started) {
+		loaders.started = true;
+#if !defined(LIMITED_FDS)
+		/* Leave one core for the main thread. */
+		uint count = min<uint>(std::thread::hardware_concurrency(), 5);
+		for (uint i = 1; i < count; i++) {
+			std::thread thread;
+			if (!StartNewThread(&thread, "ottd:sprites", &AsyncSpriteLoaderThread)) break;
+			loaders.threads.push_back(std::move(thread));
+		}
+#endif
+		DEBUG(sprite, 3, "Started " PRINTF_SIZE " background sprite loader threads", loaders.threads.size());
+	}
+	return !loaders.threads.empty();
+}
+
+/**
+ * Get the placeholder to draw for sprites being loaded in the background, encoded for the current blitter.
+ * @return The placeholder sprite.
+ */
+static void *GetAsyncSpritePlaceholder()
+{
+	if (_async_sprite_placeholder == nullptr) {
+		SpriteLoader::Sprite sprite[ZOOM_LVL_COUNT];
+		for (ZoomLevel zoom = ZOOM_LVL_BEGIN; zoom != ZOOM_LVL_END; zoom++) {
+			sprite[zoom].type = ST_NORMAL;
+			sprite[zoom].width = 1;
+			sprite[zoom].height = 1;
+			sprite[zoom].x_offs = 0;
+			sprite[zoom].y_offs = 0;
+			sprite[zoom].AllocateData(zoom, 1); // A single transparent pixel.
+		}
+		BlitterFactory::GetCurrentBlitter()->Encode(sprite, AsyncSpriteAlloc);
+		_async_sprite_placeholder = _async_sprite_allocation;
+		_async_sprite_allocation = nullptr;
+	}
+	return _async_sprite_placeholder;
+}
+
+/**
+ * Request loading a sprite in the background while drawing a viewport.
+ * @param sprite The sprite.
+ * @param sc Sprite cache entry of the sprite.
+ * @return Whether the sprite is loaded in the background.
+ */
+static bool RequestAsyncSpriteLoad(SpriteID sprite, const SpriteCache *sc)
+{
+	auto it = _async_sprite_requests.find(sprite);
+	if (it != _async_sprite_requests.end()) {
+		Rect &area = it->second;
+		area.left = min(area.left, _async_sprite_area.left);
+		area.top = min(area.top, _async_sprite_area.top);
+		area.right = max(area.right, _async_sprite_area.right);
+		area.bottom = max(area.bottom, _async_sprite_area.bottom);
+		return true;
+	}
+
+	if (!StartAsyncSpriteLoaders()) return false;
+
+	_async_sprite_requests[sprite] = _async_sprite_area;
+	{
+		std::lock_guard<std::mutex> lock(_async_sprite_loaders.lock);
+		_async_sprite_loaders.jobs.push_back({ sprite, sc->file_pos, sc->id, sc->file_slot, sc->container_ver });
+	}
+	_async_sprite_loaders.work_available.notify_one();
+	return true;
+}
+
+/**
+ * Allow normal sprites which are not in the sprite cache to be loaded in the background, while drawing an area of a viewport to the screen.
+ * @param left Left edge of the area being drawn. (viewport coordinates, that is wrt. #ZOOM_LVL_NORMAL)
+ * @param top Top edge of the area being drawn.
+ * @param right Right edge of the area being drawn.
+ * @param bottom Bottom edge of the area being drawn.
+ */
+void BeginAsyncSpriteLoading(int left, int top, int right, int bottom)
+{
+	_async_sprite_area_active = true;
+	_async_sprite_area = { left, top, right, bottom };
+}
+
+/**
+ * Stop loading sprites in the background, see #BeginAsyncSpriteLoading.
+ */
+void EndAsyncSpriteLoading()
+{
+	_async_sprite_area_active = false;
+}
+
+/**
+ * Move the sprites loaded in the background into the sprite cache, and mark the viewport areas they were requested for dirty.
+ */
+void ProcessAsyncSpriteLoads()
+{
+	if (_async_sprite_requests.empty()) return;
+
+	std::vector<AsyncSpriteLoadResult> results;
+	{
+		std::lock_guard<std::mutex> lock(_async_sprite_loaders.lock);
+		results.swap(_async_sprite_loaders.results);
+	}
+
+	for (const AsyncSpriteLoadResult &result : results) {
+		auto it = _async_sprite_requests.find(result.sprite);
+		assert(it != _async_sprite_requests.end());
+		Rect area = it->second;
+		_async_sprite_requests.erase(it);
+
+		for (const SpriteLoaderMessage &msg : result.messages) {
+			PrintSpriteLoaderMessage(msg);
+		}
+
+		SpriteCache *sc = GetSpriteCache(result.sprite);
+		if (result.data == nullptr) {
+			/* Load it normally, this reports any errors. */
+			GetRawSprite(result.sprite, ST_NORMAL);
+		} else if (sc->GetPtr() == nullptr && sc->GetType() == ST_NORMAL) {
+			/* Allocate through the sprite cache like sprites loaded on the main thread. */
+			void *ptr = AllocSprite(result.size);
+			MemCpyT((byte *)ptr, (const byte *)result.data, result.size);
+			sc->buffer = std::move(_last_sprite_allocation);
+			sc->lru = ++_sprite_lru_counter;
+		}
+		free(result.data);
+
+		MarkAllViewportsDirty(area.left, area.top, area.right, area.bottom);
+	}
+}
+
+/**
+ * Wait for the background sprite loaders to finish their current jobs, and discard all queued jobs and results.
+ * This has to be done before the sprite cache, the files or the blitter change.
+ */
+void DiscardAsyncSpriteLoads()
+{
+	AsyncSpriteLoaders &loaders = _async_sprite_loaders;
+	{
+		std::unique_lock<std::mutex> lock(loaders.lock);
+		loaders.jobs.clear();
+		loaders.work_done.wait(lock, [&]() { return loaders.busy == 0; });
+		for (AsyncSpriteLoadResult &result : loaders.results) {
+			free(result.data);
+		}
+		loaders.results.clear();
+	}
+
+	/* Viewports may still show placeholders. */
+	if (!_async_sprite_requests.empty()) MarkWholeScreenDirty();
+	_async_sprite_requests.clear();
+
+	free(_async_sprite_placeholder);
+	_async_sprite_placeholder = nullptr;
+}
+
+/**
+ * Stop the background sprite loader threads.
+ */
+void StopAsyncSpriteLoaders()
+{
+	DiscardAsyncSpriteLoads();
+
+	AsyncSpriteLoaders &loaders = _async_sprite_loaders;
+	{
+		std::lock_guard<std::mutex> lock(loaders.lock);
+		loaders.stop = true;
+	}
+	loaders.work_available.notify_all();
+	for (std::thread &thread : loaders.threads) {
+		thread.join();
+	}
+	loaders.threads.clear();
+	loaders.stop = false;
+	loaders.started = false;
+}
+
 /**
  * Handles the case when a sprite of different type is requested than is present in the SpriteCache.
  * For ST_FONT sprites, it is normal. In other cases, default sprite is loaded instead.
@@ -847,6 +1204,9 @@ void *GetRawSprite(SpriteID sprite, SpriteType type, AllocatorProc *allocator)
 
 		/* Load the sprite, if it is not loaded, yet */
 		if (sc->GetPtr() == nullptr) {
+			/* While drawing a viewport, draw a placeholder while the sprite is loaded in the background. */
+			if (_async_sprite_area_active && type == ST_NORMAL && RequestAsyncSpriteLoad(sprite, sc)) return GetAsyncSpritePlaceholder();
+
 			void *ptr = ReadSprite(sc, sprite, type, AllocSprite);
 			assert(ptr == _last_sprite_allocation.GetPtr());
 			sc->buffer = std::move(_last_sprite_allocation);
@@ -958,6 +1318,8 @@ uint32 GetSpriteMainColour(SpriteID sprite_id, PaletteID palette_id)
 
 void GfxInitSpriteMem()
 {
+	DiscardAsyncSpriteLoads();
+
 	/* Reset the spritecache 'pool' */
 	_spritecache.clear();
 	assert(_spritecache_bytes_used == 0);
@@ -969,6 +1331,8 @@ void GfxInitSpriteMem()
  */
 void GfxClearSpriteCache()
 {
+	DiscardAsyncSpriteLoads();
+
 	/* Clear sprite ptr for all cached items */
 	for (uint i = 0; i != _spritecache.size(); i++) {
 		SpriteCache *sc = GetSpriteCache(i);
@@ -976,4 +1340,4 @@ void GfxClearSpriteCache()
 	}
 }
 
-/* static */ ReusableBuffer<SpriteLoader::CommonPixel> SpriteLoader::Sprite::buffer[ZOOM_LVL_COUNT];
+/* static */ thread_local ReusableBuffer<SpriteLoader::CommonPixel> SpriteLoader::Sprite::buffer[ZOOM_LVL_COUNT];
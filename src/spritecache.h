@@ -11,6 +11,7 @@
 #define SPRITECACHE_H
 
 #include "gfx_type.h"
+#include "3rdparty/cpp-btree/btree_map.h"
 
 /** Data structure describing a sprite. */
 struct Sprite {
@@ -51,7 +52,18 @@ void GfxInitSpriteMem();
 void GfxClearSpriteCache();
 void IncreaseSpriteLRU();
 
+void BeginAsyncSpriteLoading(int left, int top, int right, int bottom);
+void EndAsyncSpriteLoading();
+void ProcessAsyncSpriteLoads();
+void DiscardAsyncSpriteLoads();
+void StopAsyncSpriteLoaders();
+
+/** Map from sprite numbers to position in the GRF file. */
+typedef btree::btree_map<uint32, size_t> GRFSpriteOffsets;
+
 void ReadGRFSpriteOffsets(byte container_version);
+bool ReadGRFSpriteOffsetsFromFile(FILE *f, GRFSpriteOffsets &offsets);
+void SetGRFSpriteOffsets(const GRFSpriteOffsets &offsets);
 size_t GetGRFSpriteOffset(uint32 id);
 bool LoadNextSprite(int load_index, uint file_index, uint file_sprite_id, byte container_version);
 bool SkipSpriteData(byte type, uint16 num);
@@ -12,6 +12,9 @@
 
 #include "spriteloader.hpp"
 
+#include <string>
+#include <vector>
+
 /** Sprite loader for graphics coming from a (New)GRF. */
 class SpriteLoaderGrf : public SpriteLoader {
 	byte container_ver;
@@ -20,4 +23,21 @@ public:
 	uint8 LoadSprite(SpriteLoader::Sprite *sprite, uint file_slot, size_t file_pos, SpriteType sprite_type, bool load_32bpp);
 };
 
+/** Set when a sprite loader running on a thread other than the main thread found a corrupt sprite, which it could not report. */
+extern thread_local bool _grf_corrupt_sprite_in_thread;
+
+/** A debug message of a sprite loader running on a thread other than the main thread, which has to be printed by the main thread. */
+struct SpriteLoaderMessage {
+	int level;           ///< Debug level of the message, or #SPRITE_LOADER_WARNING_ONCE.
+	std::string message; ///< The message.
+};
+
+/** Debug level of warnings which are shown at level 0 the first time, and at level 6 afterwards. */
+static const int SPRITE_LOADER_WARNING_ONCE = -1;
+
+/** Debug messages of the sprite loader running on this thread, if it is not the main thread. */
+extern thread_local std::vector<SpriteLoaderMessage> _grf_sprite_loader_messages;
+
+void PrintSpriteLoaderMessage(const SpriteLoaderMessage &msg);
+
 #endif /* SPRITELOADER_GRF_HPP */
@@ -795,6 +795,8 @@ public:
 
 	BitmapTileArea catchment_tiles; ///< NOSAVE: Set of individual tiles covered by catchment area
 	uint station_tiles;             ///< NOSAVE: Count of station tiles owned by this station
+	uint64 rating_tick_base;        ///< NOSAVE: Station tick at which #delete_ctr was last brought up to date
+	uint64 rating_due_tick;         ///< NOSAVE: Station tick of the next rating update, 0 if the station is not in use
 
 	StationHadVehicleOfType had_vehicle_of_type;
 
@@ -716,6 +716,94 @@ static CommandCost BuildStationPart(Station **st, DoCommandFlag flags, bool reus
 	return CommandCost();
 }
 
+/** Number of times OnTick_Station has run since the game was started. */
+static uint64 _station_tick = 0;
+
+/**
+ * Stations due for a rating update, bucketed by (#Station::rating_due_tick % #STATION_RATING_TICKS).
+ * Entries for stations which have since been deleted or rescheduled are stale, and ignored when the bucket is processed.
+ */
+static std::vector<StationID> _station_rating_buckets[STATION_RATING_TICKS];
+
+/**
+ * Get the current value of the rating counter (#BaseStation::delete_ctr) of a station.
+ * While a station is in use its counter is not incremented every tick, instead it is derived
+ * from the number of station ticks since #Station::rating_tick_base when it is needed.
+ * @param st The station.
+ * @return The current rating counter.
+ */
+byte GetStationRatingCounter(const Station *st)
+{
+	const uint64 elapsed = _station_tick - st->rating_tick_base;
+	if (st->rating_due_tick == 0 || elapsed == 0) return st->delete_ctr;
+
+	/* Equivalent to running StationHandleSmallTick elapsed times. */
+	if (st->delete_ctr >= STATION_RATING_TICKS - 1) return (elapsed - 1) % STATION_RATING_TICKS;
+	return (st->delete_ctr + elapsed) % STATION_RATING_TICKS;
+}
+
+/**
+ * Bring the rating counter (#BaseStation::delete_ctr) of a station up to date.
+ * @param st The station.
+ */
+static void SyncStationRatingCounter(Station *st)
+{
+	st->delete_ctr = GetStationRatingCounter(st);
+	st->rating_tick_base = _station_tick;
+}
+
+/**
+ * Schedule the next rating update of a station, from its current rating counter.
+ * The counter must be up to date, see SyncStationRatingCounter.
+ * @param st The station.
+ */
+static void ScheduleStationRating(Station *st)
+{
+	assert(st->rating_tick_base == _station_tick);
+
+	if (!st->IsInUse()) {
+		st->rating_due_tick = 0;
+		return;
+	}
+
+	st->rating_due_tick = _station_tick + (st->delete_ctr >= STATION_RATING_TICKS - 1 ? 1 : STATION_RATING_TICKS - st->delete_ctr);
+	_station_rating_buckets[st->rating_due_tick % STATION_RATING_TICKS].push_back(st->index);
+}
+
+/**
+ * Update the rating schedule of a station after its facilities have changed.
+ * @param st The station.
+ */
+void UpdateStationRatingSchedule(Station *st)
+{
+	SyncStationRatingCounter(st);
+	ScheduleStationRating(st);
+}
+
+/**
+ * Bring the rating counters of all stations up to date, before they are saved.
+ */
+void SyncStationRatingCounters()
+{
+	for (Station *st : Station::Iterate()) {
+		SyncStationRatingCounter(st);
+	}
+}
+
+/**
+ * Rebuild the rating schedule of all stations from their rating counters, after loading a game.
+ */
+void RebuildStationRatingSchedule()
+{
+	for (std::vector<StationID> &bucket : _station_rating_buckets) {
+		bucket.clear();
+	}
+	for (Station *st : Station::Iterate()) {
+		st->rating_tick_base = _station_tick;
+		ScheduleStationRating(st);
+	}
+}
+
 /**
  * This is called right after a station was deleted.
  * It checks if the whole station is free of substations, and if so, the station will be
@@ -724,10 +812,12 @@ static CommandCost BuildStationPart(Station **st, DoCommandFlag flags, bool reus
  */
 static void DeleteStationIfEmpty(BaseStation *st)
 {
+	if (Station::IsExpected(st)) SyncStationRatingCounter(Station::From(st));
 	if (!st->IsInUse()) {
 		st->delete_ctr = 0;
 		InvalidateWindowData(WC_STATION_LIST, st->owner, 0);
 	}
+	if (Station::IsExpected(st)) ScheduleStationRating(Station::From(st));
 	/* station remains but it probably lost some parts - station sign should stay in the station boundaries */
 	UpdateStationSignCoord(st);
 }
@@ -4038,24 +4128,55 @@ void IncreaseStats(Station *st, CargoID cargo, StationID next_station_id, uint c
 	}
 }
 
-/* called for every station each tick */
-static void StationHandleSmallTick(BaseStation *st)
+/**
+ * Rating tick of a station, this replaces incrementing the rating counter of each station every tick.
+ * It is called when the rating counter of the station wraps around, every STATION_RATING_TICKS ticks.
+ * @param st the station receiving the tick.
+ */
+static void StationHandleRatingTick(Station *st)
 {
-	if ((st->facilities & FACIL_WAYPOINT) != 0 || !st->IsInUse()) return;
+	st->delete_ctr = 0;
+	st->rating_tick_base = _station_tick;
+	ScheduleStationRating(st);
 
-	byte b = st->delete_ctr + 1;
-	if (b >= STATION_RATING_TICKS) b = 0;
-	st->delete_ctr = b;
-
-	if (b == 0) UpdateStationRating(Station::From(st));
+	UpdateStationRating(st);
 }
 
 void OnTick_Station()
 {
 	if (_game_mode == GM_EDITOR) return;
 
-	for (BaseStation *st : BaseStation::Iterate()) {
-		StationHandleSmallTick(st);
+	_station_tick++;
+
+	/* Collect the stations which have something to do this tick, they are then processed in index order as before. */
+	static std::vector<StationID> due;
+	due.clear();
+
+	std::vector<StationID> &bucket = _station_rating_buckets[_station_tick % STATION_RATING_TICKS];
+	for (StationID id : bucket) {
+		const Station *st = Station::GetIfValid(id);
+		if (st != nullptr && st->rating_due_tick == _station_tick) due.push_back(id);
+	}
+	bucket.clear();
+
+	/* Stations for which (_tick_counter + st->index) % interval == 0, see below. */
+	for (uint i = (STATION_LINKGRAPH_TICKS - _tick_counter % STATION_LINKGRAPH_TICKS) % STATION_LINKGRAPH_TICKS; i < BaseStation::GetPoolSize(); i += STATION_LINKGRAPH_TICKS) {
+		due.push_back(i);
+	}
+	for (uint i = (STATION_ACCEPTANCE_TICKS - _tick_counter % STATION_ACCEPTANCE_TICKS) % STATION_ACCEPTANCE_TICKS; i < BaseStation::GetPoolSize(); i += STATION_ACCEPTANCE_TICKS) {
+		due.push_back(i);
+	}
+
+	std::sort(due.begin(), due.end());
+	due.erase(std::unique(due.begin(), due.end()), due.end());
+
+	for (StationID id : due) {
+		BaseStation *st = BaseStation::GetIfValid(id);
+		if (st == nullptr) continue;
+
+		if (Station::IsExpected(st) && Station::From(st)->rating_due_tick == _station_tick) {
+			StationHandleRatingTick(Station::From(st));
+		}
 
 		/* Clean up the link graph about once a week. */
 		if (Station::IsExpected(st) && (_tick_counter + st->index) % STATION_LINKGRAPH_TICKS == 0) {
@@ -4419,6 +4540,7 @@ void BuildOilRig(TileIndex tile)
 	st->ship_station.Add(tile);
 	st->facilities = FACIL_AIRPORT | FACIL_DOCK;
 	st->build_date = _date;
+	UpdateStationRatingSchedule(st);
 	UpdateStationDockingTiles(st);
 
 	st->rect.BeforeAddTile(tile, StationRect::ADD_FORCE);
@@ -740,7 +740,7 @@ class NIHStationStruct : public NIHelper {
 			}
 			seprintf(buffer, lastof(buffer), "  Station tiles: %u", st->station_tiles);
 			print(buffer);
-			seprintf(buffer, lastof(buffer), "  Delete counter: %u", st->delete_ctr);
+			seprintf(buffer, lastof(buffer), "  Delete counter: %u", GetStationRatingCounter(st));
 			print(buffer);
 		}
 	}
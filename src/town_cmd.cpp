@@ -446,6 +446,7 @@ void AnimateTile_Town(TileIndex tile)
 		return;
 	}
 
+	ScheduleAnimatedTile(tile, 2);
 	if (_scaled_tick_counter & 3) return;
 
 	/* If the house is not one with a lift anymore, then stop this animating.
@@ -97,7 +97,7 @@ void ClearTraceRestrictMapping() {
 }
 
 /**
- * Flags used for the program execution condition stack
+ * Flags used for the program validation condition stack
  * Each 'if' pushes onto the stack
  * Each 'end if' pops from the stack
  * Elif/orif/else may modify the stack top
@@ -230,424 +230,444 @@ static bool TestStationCondition(StationID station, TraceRestrictItem item)
 }
 
 /**
- * Execute program on train and store results in out
- * @p v may not be nullptr
- * @p out should be zero-initialised
+ * Test the condition of a conditional instruction
  */
-void TraceRestrictProgram::Execute(const Train* v, const TraceRestrictProgramInput &input, TraceRestrictProgramResult& out) const
+static bool TestInstructionCondition(const TraceRestrictInstruction &insn, const Train *v, const TraceRestrictProgramInput &input,
+		bool &have_previous_signal, TileIndex &previous_signal_tile)
 {
-	// static to avoid needing to re-alloc/resize on each execution
-	static std::vector<TraceRestrictCondStackFlags> condstack;
-	condstack.clear();
+	TraceRestrictItem item = insn.item;
+	TraceRestrictCondOp condop = GetTraceRestrictCondOp(item);
+	uint16 condvalue = GetTraceRestrictValue(item);
+	bool result = false;
+	switch (GetTraceRestrictType(item)) {
+		case TRIT_COND_UNDEFINED:
+			result = false;
+			break;
 
-	bool have_previous_signal = false;
-	TileIndex previous_signal_tile = INVALID_TILE;
+		case TRIT_COND_TRAIN_LENGTH:
+			result = TestCondition(CeilDiv(v->gcache.cached_total_length, TILE_SIZE), condop, condvalue);
+			break;
 
-	size_t size = this->items.size();
-	for (size_t i = 0; i < size; i++) {
-		TraceRestrictItem item = this->items[i];
-		TraceRestrictItemType type = GetTraceRestrictType(item);
+		case TRIT_COND_MAX_SPEED:
+			result = TestCondition(v->GetDisplayMaxSpeed(), condop, condvalue);
+			break;
 
-		if (IsTraceRestrictConditional(item)) {
-			TraceRestrictCondFlags condflags = GetTraceRestrictCondFlags(item);
-			TraceRestrictCondOp condop = GetTraceRestrictCondOp(item);
+		case TRIT_COND_CURRENT_ORDER:
+			result = TestOrderCondition(&(v->current_order), item);
+			break;
 
-			if (type == TRIT_COND_ENDIF) {
-				assert(!condstack.empty());
-				if (condflags & TRCF_ELSE) {
-					// else
-					assert(!(condstack.back() & TRCSF_SEEN_ELSE));
-					HandleCondition(condstack, condflags, true);
-					condstack.back() |= TRCSF_SEEN_ELSE;
-				} else {
-					// end if
-					condstack.pop_back();
+		case TRIT_COND_NEXT_ORDER: {
+			if (v->orders.list == nullptr) break;
+			if (v->orders.list->GetNumOrders() == 0) break;
+
+			const Order *current_order = v->GetOrder(v->cur_real_order_index);
+			for (const Order *order = v->orders.list->GetNext(current_order); order != current_order; order = v->orders.list->GetNext(order)) {
+				if (order->IsGotoOrder()) {
+					result = TestOrderCondition(order, item);
+					break;
 				}
-			} else {
-				uint16 condvalue = GetTraceRestrictValue(item);
-				bool result = false;
-				switch(type) {
-					case TRIT_COND_UNDEFINED:
-						result = false;
-						break;
+			}
+			break;
+		}
 
-					case TRIT_COND_TRAIN_LENGTH:
-						result = TestCondition(CeilDiv(v->gcache.cached_total_length, TILE_SIZE), condop, condvalue);
-						break;
+		case TRIT_COND_LAST_STATION:
+			result = TestStationCondition(v->last_station_visited, item);
+			break;
 
-					case TRIT_COND_MAX_SPEED:
-						result = TestCondition(v->GetDisplayMaxSpeed(), condop, condvalue);
-						break;
+		case TRIT_COND_CARGO: {
+			bool have_cargo = false;
+			for (const Vehicle *v_iter = v; v_iter != nullptr; v_iter = v_iter->Next()) {
+				if (v_iter->cargo_type == GetTraceRestrictValue(item) && v_iter->cargo_cap > 0) {
+					have_cargo = true;
+					break;
+				}
+			}
+			result = TestBinaryConditionCommon(item, have_cargo);
+			break;
+		}
 
-					case TRIT_COND_CURRENT_ORDER:
-						result = TestOrderCondition(&(v->current_order), item);
-						break;
+		case TRIT_COND_ENTRY_DIRECTION: {
+			bool direction_match;
+			switch (GetTraceRestrictValue(item)) {
+				case TRNTSV_NE:
+				case TRNTSV_SE:
+				case TRNTSV_SW:
+				case TRNTSV_NW:
+					direction_match = (static_cast<DiagDirection>(GetTraceRestrictValue(item)) == TrackdirToExitdir(ReverseTrackdir(input.trackdir)));
+					break;
 
-					case TRIT_COND_NEXT_ORDER: {
-						if (v->orders.list == nullptr) break;
-						if (v->orders.list->GetNumOrders() == 0) break;
+				case TRDTSV_FRONT:
+					direction_match = IsTileType(input.tile, MP_RAILWAY) && HasSignalOnTrackdir(input.tile, input.trackdir);
+					break;
 
-						const Order *current_order = v->GetOrder(v->cur_real_order_index);
-						for (const Order *order = v->orders.list->GetNext(current_order); order != current_order; order = v->orders.list->GetNext(order)) {
-							if (order->IsGotoOrder()) {
-								result = TestOrderCondition(order, item);
-								break;
-							}
-						}
-						break;
-					}
+				case TRDTSV_BACK:
+					direction_match = IsTileType(input.tile, MP_RAILWAY) && !HasSignalOnTrackdir(input.tile, input.trackdir);
+					break;
 
-					case TRIT_COND_LAST_STATION:
-						result = TestStationCondition(v->last_station_visited, item);
-						break;
+				default:
+					NOT_REACHED();
+					break;
+			}
+			result = TestBinaryConditionCommon(item, direction_match);
+			break;
+		}
 
-					case TRIT_COND_CARGO: {
-						bool have_cargo = false;
-						for (const Vehicle *v_iter = v; v_iter != nullptr; v_iter = v_iter->Next()) {
-							if (v_iter->cargo_type == GetTraceRestrictValue(item) && v_iter->cargo_cap > 0) {
-								have_cargo = true;
-								break;
-							}
-						}
-						result = TestBinaryConditionCommon(item, have_cargo);
-						break;
-					}
+		case TRIT_COND_PBS_ENTRY_SIGNAL: {
+			// TRVT_TILE_INDEX value type uses the next slot
+			uint32_t signal_tile = insn.value;
+			if (!have_previous_signal) {
+				if (input.previous_signal_callback) {
+					previous_signal_tile = input.previous_signal_callback(v, input.previous_signal_ptr);
+				}
+				have_previous_signal = true;
+			}
+			bool match = (signal_tile != INVALID_TILE)
+					&& (previous_signal_tile == signal_tile);
+			result = TestBinaryConditionCommon(item, match);
+			break;
+		}
 
-					case TRIT_COND_ENTRY_DIRECTION: {
-						bool direction_match;
-						switch (GetTraceRestrictValue(item)) {
-							case TRNTSV_NE:
-							case TRNTSV_SE:
-							case TRNTSV_SW:
-							case TRNTSV_NW:
-								direction_match = (static_cast<DiagDirection>(GetTraceRestrictValue(item)) == TrackdirToExitdir(ReverseTrackdir(input.trackdir)));
-								break;
+		case TRIT_COND_TRAIN_GROUP: {
+			result = TestBinaryConditionCommon(item, GroupIsInGroup(v->group_id, GetTraceRestrictValue(item)));
+			break;
+		}
 
-							case TRDTSV_FRONT:
-								direction_match = IsTileType(input.tile, MP_RAILWAY) && HasSignalOnTrackdir(input.tile, input.trackdir);
-								break;
+		case TRIT_COND_TRAIN_IN_SLOT: {
+			const TraceRestrictSlot *slot = TraceRestrictSlot::GetIfValid(GetTraceRestrictValue(item));
+			result = TestBinaryConditionCommon(item, slot != nullptr && slot->IsOccupant(v->index));
+			break;
+		}
 
-							case TRDTSV_BACK:
-								direction_match = IsTileType(input.tile, MP_RAILWAY) && !HasSignalOnTrackdir(input.tile, input.trackdir);
-								break;
+		case TRIT_COND_SLOT_OCCUPANCY: {
+			// TRIT_COND_SLOT_OCCUPANCY value type uses the next slot
+			uint32_t value = insn.value;
+			const TraceRestrictSlot *slot = TraceRestrictSlot::GetIfValid(GetTraceRestrictValue(item));
+			switch (static_cast<TraceRestrictSlotOccupancyCondAuxField>(GetTraceRestrictAuxField(item))) {
+				case TRSOCAF_OCCUPANTS:
+					result = TestCondition(slot != nullptr ? slot->occupants.size() : 0, condop, value);
+					break;
 
-							default:
-								NOT_REACHED();
-								break;
-						}
-						result = TestBinaryConditionCommon(item, direction_match);
-						break;
-					}
+				case TRSOCAF_REMAINING:
+					result = TestCondition(slot != nullptr ? slot->max_occupancy - slot->occupants.size() : 0, condop, value);
+					break;
 
-					case TRIT_COND_PBS_ENTRY_SIGNAL: {
-						// TRVT_TILE_INDEX value type uses the next slot
-						i++;
-						uint32_t signal_tile = this->items[i];
-						if (!have_previous_signal) {
-							if (input.previous_signal_callback) {
-								previous_signal_tile = input.previous_signal_callback(v, input.previous_signal_ptr);
-							}
-							have_previous_signal = true;
-						}
-						bool match = (signal_tile != INVALID_TILE)
-								&& (previous_signal_tile == signal_tile);
-						result = TestBinaryConditionCommon(item, match);
-						break;
-					}
+				default:
+					NOT_REACHED();
+					break;
+			}
+			break;
+		}
 
-					case TRIT_COND_TRAIN_GROUP: {
-						result = TestBinaryConditionCommon(item, GroupIsInGroup(v->group_id, GetTraceRestrictValue(item)));
-						break;
-					}
+		case TRIT_COND_PHYS_PROP: {
+			switch (static_cast<TraceRestrictPhysPropCondAuxField>(GetTraceRestrictAuxField(item))) {
+				case TRPPCAF_WEIGHT:
+					result = TestCondition(v->gcache.cached_weight, condop, condvalue);
+					break;
 
-					case TRIT_COND_TRAIN_IN_SLOT: {
-						const TraceRestrictSlot *slot = TraceRestrictSlot::GetIfValid(GetTraceRestrictValue(item));
-						result = TestBinaryConditionCommon(item, slot != nullptr && slot->IsOccupant(v->index));
-						break;
-					}
+				case TRPPCAF_POWER:
+					result = TestCondition(v->gcache.cached_power, condop, condvalue);
+					break;
 
-					case TRIT_COND_SLOT_OCCUPANCY: {
-						// TRIT_COND_SLOT_OCCUPANCY value type uses the next slot
-						i++;
-						uint32_t value = this->items[i];
-						const TraceRestrictSlot *slot = TraceRestrictSlot::GetIfValid(GetTraceRestrictValue(item));
-						switch (static_cast<TraceRestrictSlotOccupancyCondAuxField>(GetTraceRestrictAuxField(item))) {
-							case TRSOCAF_OCCUPANTS:
-								result = TestCondition(slot != nullptr ? slot->occupants.size() : 0, condop, value);
-								break;
+				case TRPPCAF_MAX_TE:
+					result = TestCondition(v->gcache.cached_max_te / 1000, condop, condvalue);
+					break;
 
-							case TRSOCAF_REMAINING:
-								result = TestCondition(slot != nullptr ? slot->max_occupancy - slot->occupants.size() : 0, condop, value);
-								break;
+				default:
+					NOT_REACHED();
+					break;
+			}
+			break;
+		}
 
-							default:
-								NOT_REACHED();
-								break;
-						}
-						break;
-					}
+		case TRIT_COND_PHYS_RATIO: {
+			switch (static_cast<TraceRestrictPhysPropRatioCondAuxField>(GetTraceRestrictAuxField(item))) {
+				case TRPPRCAF_POWER_WEIGHT:
+					result = TestCondition(min<uint>(UINT16_MAX, (100 * v->gcache.cached_power) / max<uint>(1, v->gcache.cached_weight)), condop, condvalue);
+					break;
 
-					case TRIT_COND_PHYS_PROP: {
-						switch (static_cast<TraceRestrictPhysPropCondAuxField>(GetTraceRestrictAuxField(item))) {
-							case TRPPCAF_WEIGHT:
-								result = TestCondition(v->gcache.cached_weight, condop, condvalue);
-								break;
+				case TRPPRCAF_MAX_TE_WEIGHT:
+					result = TestCondition(min<uint>(UINT16_MAX, (v->gcache.cached_max_te / 10) / max<uint>(1, v->gcache.cached_weight)), condop, condvalue);
+					break;
 
-							case TRPPCAF_POWER:
-								result = TestCondition(v->gcache.cached_power, condop, condvalue);
-								break;
+				default:
+					NOT_REACHED();
+					break;
+			}
+			break;
+		}
 
-							case TRPPCAF_MAX_TE:
-								result = TestCondition(v->gcache.cached_max_te / 1000, condop, condvalue);
-								break;
+		case TRIT_COND_TRAIN_OWNER: {
+			result = TestBinaryConditionCommon(item, v->owner == condvalue);
+			break;
+		}
 
-							default:
-								NOT_REACHED();
-								break;
+
+		case TRIT_COND_TRAIN_STATUS: {
+			bool has_status = false;
+			switch (static_cast<TraceRestrictTrainStatusValueField>(GetTraceRestrictValue(item))) {
+				case TRTSVF_EMPTY:
+					has_status = true;
+					for (const Vehicle *v_iter = v; v_iter != nullptr; v_iter = v_iter->Next()) {
+						if (v_iter->cargo.StoredCount() > 0) {
+							has_status = false;
+							break;
 						}
-						break;
 					}
+					break;
 
-					case TRIT_COND_PHYS_RATIO: {
-						switch (static_cast<TraceRestrictPhysPropRatioCondAuxField>(GetTraceRestrictAuxField(item))) {
-							case TRPPRCAF_POWER_WEIGHT:
-								result = TestCondition(min<uint>(UINT16_MAX, (100 * v->gcache.cached_power) / max<uint>(1, v->gcache.cached_weight)), condop, condvalue);
-								break;
-
-							case TRPPRCAF_MAX_TE_WEIGHT:
-								result = TestCondition(min<uint>(UINT16_MAX, (v->gcache.cached_max_te / 10) / max<uint>(1, v->gcache.cached_weight)), condop, condvalue);
-								break;
-
-							default:
-								NOT_REACHED();
-								break;
+				case TRTSVF_FULL:
+					has_status = true;
+					for (const Vehicle *v_iter = v; v_iter != nullptr; v_iter = v_iter->Next()) {
+						if (v_iter->cargo.StoredCount() < v_iter->cargo_cap) {
+							has_status = false;
+							break;
 						}
-						break;
 					}
+					break;
 
-					case TRIT_COND_TRAIN_OWNER: {
-						result = TestBinaryConditionCommon(item, v->owner == condvalue);
-						break;
-					}
+				case TRTSVF_BROKEN_DOWN:
+					has_status = v->flags & VRF_IS_BROKEN;
+					break;
 
+				case TRTSVF_NEEDS_REPAIR:
+					has_status = v->critical_breakdown_count > 0;
+					break;
 
-					case TRIT_COND_TRAIN_STATUS: {
-						bool has_status = false;
-						switch (static_cast<TraceRestrictTrainStatusValueField>(GetTraceRestrictValue(item))) {
-							case TRTSVF_EMPTY:
-								has_status = true;
-								for (const Vehicle *v_iter = v; v_iter != nullptr; v_iter = v_iter->Next()) {
-									if (v_iter->cargo.StoredCount() > 0) {
-										has_status = false;
-										break;
-									}
-								}
-								break;
+				case TRTSVF_REVERSING:
+					has_status = v->reverse_distance > 0 || HasBit(v->flags, VRF_REVERSING);
+					break;
 
-							case TRTSVF_FULL:
-								has_status = true;
-								for (const Vehicle *v_iter = v; v_iter != nullptr; v_iter = v_iter->Next()) {
-									if (v_iter->cargo.StoredCount() < v_iter->cargo_cap) {
-										has_status = false;
-										break;
-									}
-								}
-								break;
+				case TRTSVF_HEADING_TO_STATION_WAYPOINT:
+					has_status = v->current_order.IsType(OT_GOTO_STATION) || v->current_order.IsType(OT_GOTO_WAYPOINT);
+					break;
 
-							case TRTSVF_BROKEN_DOWN:
-								has_status = v->flags & VRF_IS_BROKEN;
-								break;
+				case TRTSVF_HEADING_TO_DEPOT:
+					has_status = v->current_order.IsType(OT_GOTO_DEPOT);
+					break;
 
-							case TRTSVF_NEEDS_REPAIR:
-								has_status = v->critical_breakdown_count > 0;
-								break;
+				case TRTSVF_LOADING:
+					has_status = v->current_order.IsType(OT_LOADING) || v->current_order.IsType(OT_LOADING_ADVANCE);
+					break;
 
-							case TRTSVF_REVERSING:
-								has_status = v->reverse_distance > 0 || HasBit(v->flags, VRF_REVERSING);
-								break;
+				case TRTSVF_WAITING:
+					has_status = v->current_order.IsType(OT_WAITING);
+					break;
 
-							case TRTSVF_HEADING_TO_STATION_WAYPOINT:
-								has_status = v->current_order.IsType(OT_GOTO_STATION) || v->current_order.IsType(OT_GOTO_WAYPOINT);
-								break;
+				case TRTSVF_LOST:
+					has_status = HasBit(v->vehicle_flags, VF_PATHFINDER_LOST);
+					break;
 
-							case TRTSVF_HEADING_TO_DEPOT:
-								has_status = v->current_order.IsType(OT_GOTO_DEPOT);
-								break;
+				case TRTSVF_REQUIRES_SERVICE:
+					has_status = v->NeedsServicing();
+					break;
+			}
+			result = TestBinaryConditionCommon(item, has_status);
+			break;
+		}
 
-							case TRTSVF_LOADING:
-								has_status = v->current_order.IsType(OT_LOADING) || v->current_order.IsType(OT_LOADING_ADVANCE);
-								break;
+		case TRIT_COND_LOAD_PERCENT: {
+			result = TestCondition(CalcPercentVehicleFilled(v, nullptr), condop, condvalue);
+			break;
+		}
 
-							case TRTSVF_WAITING:
-								has_status = v->current_order.IsType(OT_WAITING);
-								break;
+		default:
+			NOT_REACHED();
+	}
+	return result;
+}
 
-							case TRTSVF_LOST:
-								has_status = HasBit(v->vehicle_flags, VF_PATHFINDER_LOST);
-								break;
+/**
+ * Execute program on train and store results in out
+ * @p v may not be nullptr, unless HasEntryDirectionResults() is true and no slot operations are permitted
+ * @p out should be zero-initialised
+ */
+void TraceRestrictProgram::Execute(const Train* v, const TraceRestrictProgramInput &input, TraceRestrictProgramResult& out) const
+{
+	bool have_previous_signal = false;
+	TileIndex previous_signal_tile = INVALID_TILE;
 
-							case TRTSVF_REQUIRES_SERVICE:
-								has_status = v->NeedsServicing();
-								break;
-						}
-						result = TestBinaryConditionCommon(item, has_status);
+	size_t size = this->instructions.size();
+	size_t i = 0;
+	while (i < size) {
+		const TraceRestrictInstruction &insn = this->instructions[i];
+		TraceRestrictItem item = insn.item;
+		TraceRestrictItemType type = GetTraceRestrictType(item);
+
+		if (IsTraceRestrictConditional(item)) {
+			TraceRestrictCondFlags condflags = GetTraceRestrictCondFlags(item);
+
+			if (type == TRIT_COND_ENDIF) {
+				if (condflags & TRCF_ELSE) {
+					// else, reached at the end of the branch taken
+					i = insn.end_if + 1;
+				} else {
+					// end if
+					i++;
+				}
+			} else if (condflags & TRCF_OR) {
+				// orif, reached at the end of the branch taken, which continues
+				i++;
+			} else if (condflags & TRCF_ELSE) {
+				// elif, reached at the end of the branch taken
+				i = insn.end_if + 1;
+			} else {
+				// if, take the first branch with a true condition, skipping over the others
+				for (;;) {
+					if (TestInstructionCondition(this->instructions[i], v, input, have_previous_signal, previous_signal_tile)) {
+						i++;
+						break;
+					}
+					i = this->instructions[i].next_clause;
+					if (GetTraceRestrictType(this->instructions[i].item) == TRIT_COND_ENDIF) {
+						// else or end if
+						i++;
 						break;
 					}
+				}
+			}
+			continue;
+		}
+
+		switch (type) {
+			case TRIT_PF_DENY:
+				if (GetTraceRestrictValue(item)) {
+					out.flags &= ~TRPRF_DENY;
+				} else {
+					out.flags |= TRPRF_DENY;
+				}
+				break;
 
-					case TRIT_COND_LOAD_PERCENT: {
-						result = TestCondition(CalcPercentVehicleFilled(v, nullptr), condop, condvalue);
+			case TRIT_PF_PENALTY:
+				switch (static_cast<TraceRestrictPathfinderPenaltyAuxField>(GetTraceRestrictAuxField(item))) {
+					case TRPPAF_VALUE:
+						out.penalty += GetTraceRestrictValue(item);
+						break;
+
+					case TRPPAF_PRESET: {
+						uint16 index = GetTraceRestrictValue(item);
+						assert(index < TRPPPI_END);
+						out.penalty += _tracerestrict_pathfinder_penalty_preset_values[index];
 						break;
 					}
 
 					default:
 						NOT_REACHED();
 				}
-				HandleCondition(condstack, condflags, result);
-			}
-		} else {
-			if (condstack.empty() || condstack.back() & TRCSF_ACTIVE) {
-				switch(type) {
-					case TRIT_PF_DENY:
-						if (GetTraceRestrictValue(item)) {
-							out.flags &= ~TRPRF_DENY;
-						} else {
-							out.flags |= TRPRF_DENY;
-						}
-						break;
+				break;
 
-					case TRIT_PF_PENALTY:
-						switch (static_cast<TraceRestrictPathfinderPenaltyAuxField>(GetTraceRestrictAuxField(item))) {
-							case TRPPAF_VALUE:
-								out.penalty += GetTraceRestrictValue(item);
-								break;
+			case TRIT_RESERVE_THROUGH:
+				if (GetTraceRestrictValue(item)) {
+					out.flags &= ~TRPRF_RESERVE_THROUGH;
+				} else {
+					out.flags |= TRPRF_RESERVE_THROUGH;
+				}
+				break;
 
-							case TRPPAF_PRESET: {
-								uint16 index = GetTraceRestrictValue(item);
-								assert(index < TRPPPI_END);
-								out.penalty += _tracerestrict_pathfinder_penalty_preset_values[index];
-								break;
-							}
+			case TRIT_LONG_RESERVE:
+				if (GetTraceRestrictValue(item)) {
+					out.flags &= ~TRPRF_LONG_RESERVE;
+				} else {
+					out.flags |= TRPRF_LONG_RESERVE;
+				}
+				break;
 
-							default:
-								NOT_REACHED();
-						}
+			case TRIT_WAIT_AT_PBS:
+				switch (static_cast<TraceRestrictWaitAtPbsValueField>(GetTraceRestrictValue(item))) {
+					case TRWAPVF_WAIT_AT_PBS:
+						out.flags |= TRPRF_WAIT_AT_PBS;
 						break;
 
-					case TRIT_RESERVE_THROUGH:
-						if (GetTraceRestrictValue(item)) {
-							out.flags &= ~TRPRF_RESERVE_THROUGH;
-						} else {
-							out.flags |= TRPRF_RESERVE_THROUGH;
-						}
+					case TRWAPVF_CANCEL_WAIT_AT_PBS:
+						out.flags &= ~TRPRF_WAIT_AT_PBS;
 						break;
 
-					case TRIT_LONG_RESERVE:
-						if (GetTraceRestrictValue(item)) {
-							out.flags &= ~TRPRF_LONG_RESERVE;
-						} else {
-							out.flags |= TRPRF_LONG_RESERVE;
-						}
+					case TRWAPVF_PBS_RES_END_WAIT:
+						out.flags |= TRPRF_PBS_RES_END_WAIT;
 						break;
 
-					case TRIT_WAIT_AT_PBS:
-						switch (static_cast<TraceRestrictWaitAtPbsValueField>(GetTraceRestrictValue(item))) {
-							case TRWAPVF_WAIT_AT_PBS:
-								out.flags |= TRPRF_WAIT_AT_PBS;
-								break;
-
-							case TRWAPVF_CANCEL_WAIT_AT_PBS:
-								out.flags &= ~TRPRF_WAIT_AT_PBS;
-								break;
-
-							case TRWAPVF_PBS_RES_END_WAIT:
-								out.flags |= TRPRF_PBS_RES_END_WAIT;
-								break;
+					case TRWAPVF_CANCEL_PBS_RES_END_WAIT:
+						out.flags &= ~TRPRF_PBS_RES_END_WAIT;
+						break;
 
-							case TRWAPVF_CANCEL_PBS_RES_END_WAIT:
-								out.flags &= ~TRPRF_PBS_RES_END_WAIT;
-								break;
+					default:
+						NOT_REACHED();
+						break;
+				}
+				break;
 
-							default:
-								NOT_REACHED();
-								break;
+			case TRIT_SLOT: {
+				if (!input.permitted_slot_operations) break;
+				TraceRestrictSlot *slot = TraceRestrictSlot::GetIfValid(GetTraceRestrictValue(item));
+				if (slot == nullptr) break;
+				switch (static_cast<TraceRestrictSlotCondOpField>(GetTraceRestrictCondOp(item))) {
+					case TRSCOF_ACQUIRE_WAIT:
+						if (input.permitted_slot_operations & TRPISP_ACQUIRE) {
+							if (!slot->Occupy(v->index)) out.flags |= TRPRF_WAIT_AT_PBS;
 						}
 						break;
 
-					case TRIT_SLOT: {
-						if (!input.permitted_slot_operations) break;
-						TraceRestrictSlot *slot = TraceRestrictSlot::GetIfValid(GetTraceRestrictValue(item));
-						if (slot == nullptr) break;
-						switch (static_cast<TraceRestrictSlotCondOpField>(GetTraceRestrictCondOp(item))) {
-							case TRSCOF_ACQUIRE_WAIT:
-								if (input.permitted_slot_operations & TRPISP_ACQUIRE) {
-									if (!slot->Occupy(v->index)) out.flags |= TRPRF_WAIT_AT_PBS;
-								}
-								break;
-
-							case TRSCOF_ACQUIRE_TRY:
-								if (input.permitted_slot_operations & TRPISP_ACQUIRE) slot->Occupy(v->index);
-								break;
-
-							case TRSCOF_RELEASE_BACK:
-								if (input.permitted_slot_operations & TRPISP_RELEASE_BACK) slot->Vacate(v->index);
-								break;
-
-							case TRSCOF_RELEASE_FRONT:
-								if (input.permitted_slot_operations & TRPISP_RELEASE_FRONT) slot->Vacate(v->index);
-								break;
-
-							case TRSCOF_PBS_RES_END_ACQ_WAIT:
-								if (input.permitted_slot_operations & TRPISP_PBS_RES_END_ACQUIRE) {
-									if (!slot->Occupy(v->index)) out.flags |= TRPRF_PBS_RES_END_WAIT;
-								} else if (input.permitted_slot_operations & TRPISP_PBS_RES_END_ACQ_DRY) {
-									if (!slot->OccupyDryRun(v->index)) out.flags |= TRPRF_PBS_RES_END_WAIT;
-								}
-								break;
+					case TRSCOF_ACQUIRE_TRY:
+						if (input.permitted_slot_operations & TRPISP_ACQUIRE) slot->Occupy(v->index);
+						break;
 
-							case TRSCOF_PBS_RES_END_ACQ_TRY:
-								if (input.permitted_slot_operations & TRPISP_PBS_RES_END_ACQUIRE) slot->Occupy(v->index);
-								break;
+					case TRSCOF_RELEASE_BACK:
+						if (input.permitted_slot_operations & TRPISP_RELEASE_BACK) slot->Vacate(v->index);
+						break;
 
-							case TRSCOF_PBS_RES_END_RELEASE:
-								if (input.permitted_slot_operations & TRPISP_PBS_RES_END_RELEASE) slot->Vacate(v->index);
-								break;
+					case TRSCOF_RELEASE_FRONT:
+						if (input.permitted_slot_operations & TRPISP_RELEASE_FRONT) slot->Vacate(v->index);
+						break;
 
-							default:
-								NOT_REACHED();
-								break;
+					case TRSCOF_PBS_RES_END_ACQ_WAIT:
+						if (input.permitted_slot_operations & TRPISP_PBS_RES_END_ACQUIRE) {
+							if (!slot->Occupy(v->index)) out.flags |= TRPRF_PBS_RES_END_WAIT;
+						} else if (input.permitted_slot_operations & TRPISP_PBS_RES_END_ACQ_DRY) {
+							if (!slot->OccupyDryRun(v->index)) out.flags |= TRPRF_PBS_RES_END_WAIT;
 						}
 						break;
-					}
 
-					case TRIT_REVERSE:
-						switch (static_cast<TraceRestrictReverseValueField>(GetTraceRestrictValue(item))) {
-							case TRRVF_REVERSE:
-								out.flags |= TRPRF_REVERSE;
-								break;
+					case TRSCOF_PBS_RES_END_ACQ_TRY:
+						if (input.permitted_slot_operations & TRPISP_PBS_RES_END_ACQUIRE) slot->Occupy(v->index);
+						break;
 
-							case TRRVF_CANCEL_REVERSE:
-								out.flags &= ~TRPRF_REVERSE;
-								break;
+					case TRSCOF_PBS_RES_END_RELEASE:
+						if (input.permitted_slot_operations & TRPISP_PBS_RES_END_RELEASE) slot->Vacate(v->index);
+						break;
 
-							default:
-								NOT_REACHED();
-								break;
-						}
+					default:
+						NOT_REACHED();
 						break;
+				}
+				break;
+			}
 
-					case TRIT_SPEED_RESTRICTION: {
-						out.speed_restriction = GetTraceRestrictValue(item);
-						out.flags |= TRPRF_SPEED_RETRICTION_SET;
+			case TRIT_REVERSE:
+				switch (static_cast<TraceRestrictReverseValueField>(GetTraceRestrictValue(item))) {
+					case TRRVF_REVERSE:
+						out.flags |= TRPRF_REVERSE;
+						break;
+
+					case TRRVF_CANCEL_REVERSE:
+						out.flags &= ~TRPRF_REVERSE;
 						break;
-					}
 
 					default:
 						NOT_REACHED();
+						break;
 				}
+				break;
+
+			case TRIT_SPEED_RESTRICTION: {
+				out.speed_restriction = GetTraceRestrictValue(item);
+				out.flags |= TRPRF_SPEED_RETRICTION_SET;
+				break;
 			}
+
+			default:
+				NOT_REACHED();
 		}
+		i++;
 	}
-	assert(condstack.empty());
 }
 
 /**
@@ -825,6 +845,145 @@ CommandCost TraceRestrictProgram::Validate(const std::vector<TraceRestrictItem>
 	return CommandCost();
 }
 
+/**
+ * Compile the instruction list into the form executed, and determine which inputs it reads
+ * The instruction list must be valid
+ */
+void TraceRestrictProgram::Compile()
+{
+	this->instructions.clear();
+	this->inputs_used_flags = static_cast<TraceRestrictProgramInputsUsedFlags>(0);
+
+	// index of the if and the last seen clause of each enclosing if
+	std::vector<std::pair<uint32, uint32>> ifstack;
+
+	size_t size = this->items.size();
+	for (size_t i = 0; i < size; i++) {
+		TraceRestrictInstruction insn;
+		insn.item = this->items[i];
+		insn.value = IsTraceRestrictDoubleItem(insn.item) ? this->items[++i] : 0;
+		insn.next_clause = 0;
+		insn.end_if = 0;
+
+		uint32 index = (uint32)this->instructions.size();
+		this->instructions.push_back(insn);
+
+		if (!IsTraceRestrictConditional(insn.item)) continue;
+
+		TraceRestrictItemType type = GetTraceRestrictType(insn.item);
+		TraceRestrictCondFlags condflags = GetTraceRestrictCondFlags(insn.item);
+		if (type != TRIT_COND_ENDIF && !(condflags & (TRCF_OR | TRCF_ELSE))) {
+			// if
+			ifstack.push_back(std::make_pair(index, index));
+		} else {
+			// elif, orif, else or end if
+			assert(!ifstack.empty());
+			this->instructions[ifstack.back().second].next_clause = index;
+			ifstack.back().second = index;
+			if (type == TRIT_COND_ENDIF && !(condflags & TRCF_ELSE)) {
+				for (uint32 clause = ifstack.back().first; clause != index; clause = this->instructions[clause].next_clause) {
+					this->instructions[clause].end_if = index;
+				}
+				this->instructions[index].end_if = index;
+				ifstack.pop_back();
+			}
+		}
+
+		switch (type) {
+			case TRIT_COND_ENDIF:
+			case TRIT_COND_UNDEFINED:
+				break;
+
+			case TRIT_COND_ENTRY_DIRECTION:
+				switch (GetTraceRestrictValue(insn.item)) {
+					case TRDTSV_FRONT:
+					case TRDTSV_BACK:
+						this->inputs_used_flags |= TRPIUF_SIGNAL_FACE;
+						break;
+
+					default:
+						this->inputs_used_flags |= TRPIUF_ENTRY_DIRECTION;
+						break;
+				}
+				break;
+
+			case TRIT_COND_PBS_ENTRY_SIGNAL:
+				this->inputs_used_flags |= TRPIUF_PREVIOUS_SIGNAL;
+				break;
+
+			case TRIT_COND_TRAIN_IN_SLOT:
+				this->inputs_used_flags |= TRPIUF_TRAIN | TRPIUF_SLOT;
+				break;
+
+			case TRIT_COND_SLOT_OCCUPANCY:
+				this->inputs_used_flags |= TRPIUF_SLOT;
+				break;
+
+			default:
+				this->inputs_used_flags |= TRPIUF_TRAIN;
+				break;
+		}
+	}
+	assert(ifstack.empty());
+
+	if (this->HasEntryDirectionResults()) {
+		for (DiagDirection dir = DIAGDIR_BEGIN; dir != DIAGDIR_END; dir++) {
+			TraceRestrictProgramResult &out = this->entry_direction_results[dir];
+			out = TraceRestrictProgramResult();
+			out.speed_restriction = 0;
+			this->Execute(nullptr, TraceRestrictProgramInput(INVALID_TILE, ReverseTrackdir(DiagDirToDiagTrackdir(dir)), nullptr, nullptr), out);
+		}
+	}
+}
+
+/**
+ * Check that compiling each program again yields the same compiled form
+ */
+void TraceRestrictProgram::ValidateCompiledPrograms(std::function<void(const char *)> log)
+{
+	char cclog_buffer[1024];
+#define CCLOG(...) { \
+	seprintf(cclog_buffer, lastof(cclog_buffer), __VA_ARGS__); \
+	DEBUG(desync, 0, "%s", cclog_buffer); \
+	if (log) log(cclog_buffer); \
+}
+
+	for (TraceRestrictProgram *prog : TraceRestrictProgram::Iterate()) {
+		std::vector<TraceRestrictInstruction> old_instructions = prog->instructions;
+		TraceRestrictProgramInputsUsedFlags old_inputs_used_flags = prog->inputs_used_flags;
+		TraceRestrictProgramResult old_entry_direction_results[DIAGDIR_END];
+		MemCpyT(old_entry_direction_results, prog->entry_direction_results, DIAGDIR_END);
+
+		prog->Compile();
+
+		bool instructions_match = (old_instructions.size() == prog->instructions.size());
+		for (size_t i = 0; instructions_match && i < old_instructions.size(); i++) {
+			const TraceRestrictInstruction &a = old_instructions[i];
+			const TraceRestrictInstruction &b = prog->instructions[i];
+			instructions_match = (a.item == b.item && a.value == b.value && a.next_clause == b.next_clause && a.end_if == b.end_if);
+		}
+		if (!instructions_match) CCLOG("Trace restrict program %u: compiled instructions mismatch", prog->index);
+		if (old_inputs_used_flags != prog->inputs_used_flags) {
+			CCLOG("Trace restrict program %u: inputs used flags mismatch: %X != %X", prog->index, (uint)old_inputs_used_flags, (uint)prog->inputs_used_flags);
+		}
+		if (prog->HasEntryDirectionResults()) {
+			for (DiagDirection dir = DIAGDIR_BEGIN; dir != DIAGDIR_END; dir++) {
+				const TraceRestrictProgramResult &a = old_entry_direction_results[dir];
+				const TraceRestrictProgramResult &b = prog->entry_direction_results[dir];
+				if (a.penalty != b.penalty || a.flags != b.flags || a.speed_restriction != b.speed_restriction) {
+					CCLOG("Trace restrict program %u: entry direction %u result mismatch", prog->index, (uint)dir);
+				}
+			}
+		}
+
+		/* Keep the state which was checked */
+		prog->instructions.swap(old_instructions);
+		prog->inputs_used_flags = old_inputs_used_flags;
+		MemCpyT(prog->entry_direction_results, old_entry_direction_results, DIAGDIR_END);
+	}
+#undef CCLOG
+}
+
 /**
  * Convert an instruction index into an item array index
  */
@@ -1386,6 +1545,7 @@ CommandCost CmdProgramSignalTraceRestrict(TileIndex tile, DoCommandFlag flags, u
 		// move in modified program
 		prog->items.swap(items);
 		prog->actions_used_flags = actions_used_flags;
+		prog->Compile();
 
 		if (prog->items.size() == 0 && prog->refcount == 1) {
 			// program is empty, and this tile is the only reference to it
@@ -1560,6 +1720,7 @@ void TraceRestrictRemoveDestinationID(TraceRestrictOrderCondAuxField type, uint1
 			}
 			if (IsTraceRestrictDoubleItem(item)) i++;
 		}
+		prog->Compile(); // instructions may have been updated in-place
 	}
 
 	// update windows
@@ -1580,6 +1741,7 @@ void TraceRestrictRemoveGroupID(GroupID index)
 			}
 			if (IsTraceRestrictDoubleItem(item)) i++;
 		}
+		prog->Compile(); // instructions may have been updated in-place
 	}
 
 	// update windows
@@ -1603,6 +1765,7 @@ void TraceRestrictUpdateCompanyID(CompanyID old_company, CompanyID new_company)
 			}
 			if (IsTraceRestrictDoubleItem(item)) i++;
 		}
+		prog->Compile(); // instructions may have been updated in-place
 	}
 
 	for (TraceRestrictSlot *slot : TraceRestrictSlot::Iterate()) {
@@ -1806,6 +1969,7 @@ void TraceRestrictRemoveSlotID(TraceRestrictSlotID index)
 			}
 			if (IsTraceRestrictDoubleItem(item)) i++;
 		}
+		prog->Compile(); // instructions may have been updated in-place
 	}
 
 	bool changed_order = false;
@@ -328,6 +328,19 @@ enum TraceRestrictProgramActionsUsedFlags {
 };
 DECLARE_ENUM_AS_BIT_SET(TraceRestrictProgramActionsUsedFlags)
 
+/**
+ * Enumeration for TraceRestrictProgram::inputs_used_flags
+ * Slot actions are not included, as these do nothing unless slot operations are permitted
+ */
+enum TraceRestrictProgramInputsUsedFlags {
+	TRPIUF_TRAIN                  = 1 << 0,  ///< The state of the train is read
+	TRPIUF_ENTRY_DIRECTION        = 1 << 1,  ///< The side of the tile the signal is entered from is read
+	TRPIUF_SIGNAL_FACE            = 1 << 2,  ///< Whether the signal is entered from the front or the back is read
+	TRPIUF_PREVIOUS_SIGNAL        = 1 << 3,  ///< The previous PBS signal is read
+	TRPIUF_SLOT                   = 1 << 4,  ///< The state of a slot is read
+};
+DECLARE_ENUM_AS_BIT_SET(TraceRestrictProgramInputsUsedFlags)
+
 /**
  * Enumeration for TraceRestrictProgramInput::permitted_slot_operations
  */
@@ -370,6 +383,17 @@ struct TraceRestrictProgramResult {
 			: penalty(0), flags(static_cast<TraceRestrictProgramResultFlags>(0)) { }
 };
 
+/**
+ * Pre-decoded instruction of a program, as executed
+ * Conditionals store the positions to continue at, instead of using a condition stack
+ */
+struct TraceRestrictInstruction {
+	TraceRestrictItem item;                  ///< The (first) item of the instruction
+	uint32 value;                            ///< The second item of double item instructions
+	uint32 next_clause;                      ///< For if/elif/orif/else: index of the next elif/orif/else/endif of the same if
+	uint32 end_if;                           ///< For if/elif/orif/else: index of the endif of the same if
+};
+
 /**
  * Program type, this stores the instruction list
  * This is refcounted, see info at top of tracerestrict.cpp
@@ -378,12 +402,38 @@ struct TraceRestrictProgram : TraceRestrictProgramPool::PoolItem<&_tracerestrict
 	std::vector<TraceRestrictItem> items;
 	uint32 refcount;
 	TraceRestrictProgramActionsUsedFlags actions_used_flags;
+	TraceRestrictProgramInputsUsedFlags inputs_used_flags;             ///< Inputs read by the program, see Compile
+	std::vector<TraceRestrictInstruction> instructions;                ///< Compiled instruction list, see Compile
+	TraceRestrictProgramResult entry_direction_results[DIAGDIR_END];   ///< Results by entry direction, only valid if HasEntryDirectionResults()
 
 	TraceRestrictProgram()
-			: refcount(0), actions_used_flags(static_cast<TraceRestrictProgramActionsUsedFlags>(0)) { }
+			: refcount(0), actions_used_flags(static_cast<TraceRestrictProgramActionsUsedFlags>(0)), inputs_used_flags(static_cast<TraceRestrictProgramInputsUsedFlags>(0)) { }
 
 	void Execute(const Train *v, const TraceRestrictProgramInput &input, TraceRestrictProgramResult &out) const;
 
+	void Compile();
+
+	static void ValidateCompiledPrograms(std::function<void(const char *)> log);
+
+	/**
+	 * Whether the result of executing this program without permitted slot operations only depends on the side of the tile
+	 * the signal is entered from, such that GetEntryDirectionResult can be used instead of Execute
+	 */
+	bool HasEntryDirectionResults() const
+	{
+		return (this->inputs_used_flags & ~TRPIUF_ENTRY_DIRECTION) == 0;
+	}
+
+	/**
+	 * Get the result of executing this program without permitted slot operations, only valid if HasEntryDirectionResults()
+	 * @param trackdir Track direction on tile of restrict signal
+	 */
+	const TraceRestrictProgramResult &GetEntryDirectionResult(Trackdir trackdir) const
+	{
+		assert(this->HasEntryDirectionResults());
+		return this->entry_direction_results[TrackdirToExitdir(ReverseTrackdir(trackdir))];
+	}
+
 	/**
 	 * Increment ref count, only use when creating a mapping
 	 */
@@ -433,10 +483,12 @@ struct TraceRestrictProgram : TraceRestrictProgramPool::PoolItem<&_tracerestrict
 		return items.begin() + TraceRestrictProgram::InstructionOffsetToArrayOffset(items, instruction_offset);
 	}
 
-	/** Call validation function on current program instruction list and set actions_used_flags */
+	/** Call validation function on current program instruction list and set actions_used_flags, and compile it if valid */
 	CommandCost Validate()
 	{
-		return TraceRestrictProgram::Validate(items, actions_used_flags);
+		CommandCost result = TraceRestrictProgram::Validate(items, actions_used_flags);
+		if (result.Succeeded()) this->Compile();
+		return result;
 	}
 };
 
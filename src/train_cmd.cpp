@@ -2247,7 +2247,7 @@ void ReverseTrainDirection(Train *v)
 
 	AdvanceWagonsAfterSwap(v);
 
-	ClrBit(v->vcache.cached_veh_flags, VCF_GV_ZERO_SLOPE_RESIST);
+	v->InvalidateSlopeResistance();
 
 	if (IsRailDepotTile(v->tile)) {
 		InvalidateWindowData(WC_VEHICLE_DEPOT, v->tile);
@@ -3734,11 +3734,22 @@ static bool CheckTrainCollision(Train *v)
 	tcc.v = v;
 	tcc.num = 0;
 
-	/* find colliding vehicles */
+	/* find colliding vehicles, unless the broad phase shows that no other train can be near */
 	if (v->track & TRACK_BIT_WORMHOLE) {
+		TileIndex other_end = GetOtherTunnelBridgeEnd(v->tile);
+		if (IsOnlyTrainOnPos(v->tile, v->index) && IsOnlyTrainOnPos(other_end, v->index)) {
+			_train_collision_check_stats.avoided++;
+			return false;
+		}
+		_train_collision_check_stats.narrow_phase++;
 		FindVehicleOnPos(v->tile, VEH_TRAIN, &tcc, FindTrainCollideEnum);
-		FindVehicleOnPos(GetOtherTunnelBridgeEnd(v->tile), VEH_TRAIN, &tcc, FindTrainCollideEnum);
+		FindVehicleOnPos(other_end, VEH_TRAIN, &tcc, FindTrainCollideEnum);
 	} else {
+		if (IsOnlyTrainNearPosXY(v->x_pos, v->y_pos, v->index)) {
+			_train_collision_check_stats.avoided++;
+			return false;
+		}
+		_train_collision_check_stats.narrow_phase++;
 		FindVehicleOnPosXY(v->x_pos, v->y_pos, VEH_TRAIN, &tcc, FindTrainCollideEnum);
 	}
 
@@ -3933,6 +3944,22 @@ uint16 ReversingDistanceTargetSpeed(const Train *v)
 	return max(0, target_speed);
 }
 
+/**
+ * Get the track a wagon which enters a tile can take by following the vehicle in front of it, without checking the tile.
+ * This is possible when the vehicle in front entered the tile from the same side and is still on it:
+ * tracks can not be removed while a train is on them, so the track the vehicle in front took is still there.
+ * @param prev The vehicle in front of the wagon.
+ * @param tile The tile the wagon enters.
+ * @param enterdir The direction in which the wagon enters the tile.
+ * @return The track to take, or TRACK_BIT_NONE if the tile has to be checked.
+ */
+static inline TrackBits GetTrackFollowedByPrevious(const Train *prev, TileIndex tile, DiagDirection enterdir)
+{
+	if (prev->tile != tile || TileVirtXY(prev->x_pos, prev->y_pos) != tile) return TRACK_BIT_NONE;
+	if ((prev->track & ~TRACK_BIT_MASK) != TRACK_BIT_NONE || !HasExactlyOneBit(prev->track)) return TRACK_BIT_NONE;
+	return prev->track & DiagdirReachesTracks(enterdir);
+}
+
 /**
  * Move a vehicle chain one movement stop forwards.
  * @param v First vehicle to move.
@@ -4027,15 +4054,26 @@ bool TrainController(Train *v, Vehicle *nomove, bool reverse)
 
 				enter_new_tile:
 
-				/* Get the status of the tracks in the new tile and mask
-				 * away the bits that aren't reachable. */
-				TrackStatus ts = GetTileTrackStatus(gp.new_tile, TRANSPORT_RAIL, 0, (v->track & TRACK_BIT_WORMHOLE) ? INVALID_DIAGDIR : ReverseDiagDir(enterdir));
-				TrackdirBits reachable_trackdirs = DiagdirReachesTrackdirs(enterdir);
+				TrackdirBits trackdirbits = TRACKDIR_BIT_NONE;
+				TrackBits red_signals = TRACK_BIT_NONE;
+				TrackBits bits = (prev != nullptr && !(v->track & TRACK_BIT_WORMHOLE)) ? GetTrackFollowedByPrevious(prev, gp.new_tile, enterdir) : TRACK_BIT_NONE;
+				if (bits != TRACK_BIT_NONE) {
+					/* The wagon replays the track of the vehicle in front, the tile does not have to be checked again. */
+#ifdef _DEBUG
+					TrackStatus ts = GetTileTrackStatus(gp.new_tile, TRANSPORT_RAIL, 0, ReverseDiagDir(enterdir));
+					assert_msg_tile(TrackdirBitsToTrackBits(TrackStatusToTrackdirBits(ts) & DiagdirReachesTrackdirs(enterdir)) & bits, gp.new_tile, "0x%X", bits);
+#endif
+				} else {
+					/* Get the status of the tracks in the new tile and mask
+					 * away the bits that aren't reachable. */
+					TrackStatus ts = GetTileTrackStatus(gp.new_tile, TRANSPORT_RAIL, 0, (v->track & TRACK_BIT_WORMHOLE) ? INVALID_DIAGDIR : ReverseDiagDir(enterdir));
+					TrackdirBits reachable_trackdirs = DiagdirReachesTrackdirs(enterdir);
 
-				TrackdirBits trackdirbits = TrackStatusToTrackdirBits(ts) & reachable_trackdirs;
-				TrackBits red_signals = TrackdirBitsToTrackBits(TrackStatusToRedSignals(ts) & reachable_trackdirs);
+					trackdirbits = TrackStatusToTrackdirBits(ts) & reachable_trackdirs;
+					red_signals = TrackdirBitsToTrackBits(TrackStatusToRedSignals(ts) & reachable_trackdirs);
 
-				TrackBits bits = TrackdirBitsToTrackBits(trackdirbits);
+					bits = TrackdirBitsToTrackBits(trackdirbits);
+				}
 				if (Rail90DegTurnDisallowedTilesFromDiagDir(gp.old_tile, gp.new_tile, enterdir) && prev == nullptr) {
 					/* We allow wagons to make 90 deg turns, because forbid_90_deg
 					 * can be switched on halfway a turn */
@@ -4511,7 +4549,9 @@ reverse_train_direction:
 		/* Entering/exiting wormhole failed/aborted, back out changes to vehicle direction and track */
 		v->track = old_trackbits;
 		v->direction = old_direction;
+		uint16 new_gv_flags = v->gv_flags;
 		v->gv_flags = old_gv_flags;
+		v->InclinationChanged(new_gv_flags);
 	}
 	if (reverse) {
 		v->wait_counter = 0;
@@ -5430,6 +5470,9 @@ Train* CmdBuildVirtualRailVehicle(EngineID eid, StringID &error)
 
 	CheckConsistencyOfArticulatedVehicle(v);
 
+	/* Only adds the virtual vehicle to the primary vehicle indices, like for vehicles moved in CmdMoveRailVehicle. */
+	GroupStatistics::CountVehicle(v, 1);
+
 	InvalidateVehicleTickCaches();
 
 	return v;
@@ -471,6 +471,72 @@ const int HASH_RES = 0;
 
 static Vehicle *_vehicle_tile_hash[TOTAL_HASH_SIZE * 4];
 
+/**
+ * Summary of the train vehicle parts in a bucket of the tile hash, which tells quickly whether they all belong to the same train.
+ * The parts all belong to the train with ID \c id if, and only if, sum == count * id and sum_sq == count * id * id.
+ */
+struct TrainTileHashOccupancy {
+	uint32 count;  ///< Number of train vehicle parts in the bucket.
+	uint64 sum;    ///< Sum of the IDs of the first vehicles of these parts.
+	uint64 sum_sq; ///< Sum of the squared IDs of the first vehicles of these parts.
+};
+
+static TrainTileHashOccupancy _train_tile_hash_occupancy[TOTAL_HASH_SIZE];
+
+TrainCollisionCheckStats _train_collision_check_stats;
+static TrainCollisionCheckStats _last_tick_train_collision_check_stats;
+
+/**
+ * Add or remove a train vehicle part to or from the occupancy summary of its tile hash bucket.
+ * @param hash The tile hash bucket of the vehicle part.
+ * @param first The ID of the first vehicle of the train of the part.
+ * @param add True to add the part, false to remove it.
+ */
+static inline void UpdateTrainTileHashOccupancy(Vehicle * const *hash, VehicleID first, bool add)
+{
+	TrainTileHashOccupancy &occupancy = _train_tile_hash_occupancy[hash - &_vehicle_tile_hash[TOTAL_HASH_SIZE * VEH_TRAIN]];
+	uint64 id = first;
+	if (add) {
+		occupancy.count++;
+		occupancy.sum += id;
+		occupancy.sum_sq += id * id;
+	} else {
+		occupancy.count--;
+		occupancy.sum -= id;
+		occupancy.sum_sq -= id * id;
+	}
+}
+
+/**
+ * Check whether all train vehicle parts in a range of tile hash buckets belong to the same train.
+ * Only the occupancy summaries of the buckets are used, no vehicle is looked at.
+ * @param xl Lowest x index of the buckets.
+ * @param yl Lowest y index of the buckets, shifted by HASH_BITS.
+ * @param xu Highest x index of the buckets.
+ * @param yu Highest y index of the buckets, shifted by HASH_BITS.
+ * @param first The ID of the first vehicle of the train.
+ * @return True if no vehicle part of another train is in the buckets.
+ */
+static bool IsOnlyTrainInTileHash(int xl, int yl, int xu, int yu, VehicleID first)
+{
+	uint64 count = 0;
+	uint64 sum = 0;
+	uint64 sum_sq = 0;
+	for (int y = yl; ; y = (y + (1 << HASH_BITS)) & (HASH_MASK << HASH_BITS)) {
+		for (int x = xl; ; x = (x + 1) & HASH_MASK) {
+			const TrainTileHashOccupancy &occupancy = _train_tile_hash_occupancy[(x + y) & TOTAL_HASH_MASK];
+			count += occupancy.count;
+			sum += occupancy.sum;
+			sum_sq += occupancy.sum_sq;
+			if (x == xu) break;
+		}
+		if (y == yu) break;
+	}
+
+	uint64 id = first;
+	return sum == count * id && sum_sq == count * id * id;
+}
+
 static Vehicle *VehicleFromTileHash(int xl, int yl, int xu, int yu, VehicleType type, void *data, VehicleFromPosProc *proc, bool find_first)
 {
 	for (int y = yl; ; y = (y + (1 << HASH_BITS)) & (HASH_MASK << HASH_BITS)) {
@@ -513,6 +579,41 @@ Vehicle *VehicleFromPosXY(int x, int y, VehicleType type, void *data, VehicleFro
 	return VehicleFromTileHash(xl, yl, xu, yu, type, data, proc, find_first);
 }
 
+/**
+ * Check whether no vehicle part of any other train than the given one can be found by FindVehicleOnPosXY(x, y, VEH_TRAIN, ...).
+ * This is a fast check, which may return false even if no other train is near enough to be found.
+ * @param x The X location on the map
+ * @param y The Y location on the map
+ * @param first The ID of the first vehicle of the train.
+ * @return True if no vehicle part of any other train can be found.
+ */
+bool IsOnlyTrainNearPosXY(int x, int y, VehicleID first)
+{
+	const int COLL_DIST = 6;
+
+	int xl = GB((x - COLL_DIST) / TILE_SIZE, HASH_RES, HASH_BITS);
+	int xu = GB((x + COLL_DIST) / TILE_SIZE, HASH_RES, HASH_BITS);
+	int yl = GB((y - COLL_DIST) / TILE_SIZE, HASH_RES, HASH_BITS) << HASH_BITS;
+	int yu = GB((y + COLL_DIST) / TILE_SIZE, HASH_RES, HASH_BITS) << HASH_BITS;
+
+	return IsOnlyTrainInTileHash(xl, yl, xu, yu, first);
+}
+
+/**
+ * Check whether no vehicle part of any other train than the given one can be found by FindVehicleOnPos(tile, VEH_TRAIN, ...).
+ * This is a fast check, which may return false even if no other train is on the tile.
+ * @param tile The location on the map
+ * @param first The ID of the first vehicle of the train.
+ * @return True if no vehicle part of any other train can be found.
+ */
+bool IsOnlyTrainOnPos(TileIndex tile, VehicleID first)
+{
+	int x = GB(TileX(tile), HASH_RES, HASH_BITS);
+	int y = GB(TileY(tile), HASH_RES, HASH_BITS) << HASH_BITS;
+
+	return IsOnlyTrainInTileHash(x, y, x, y, first);
+}
+
 /**
  * Helper function for FindVehicleOnPos/HasVehicleOnPos.
  * @note Do not call this function directly!
@@ -719,6 +820,7 @@ void UpdateVehicleTileHash(Vehicle *v, bool remove)
 	if (old_hash != nullptr) {
 		if (v->hash_tile_next != nullptr) v->hash_tile_next->hash_tile_prev = v->hash_tile_prev;
 		*v->hash_tile_prev = v->hash_tile_next;
+		if (v->type == VEH_TRAIN) UpdateTrainTileHashOccupancy(old_hash, v->First()->index, false);
 	}
 
 	/* Insert vehicle at beginning of the new position in the hash table */
@@ -727,12 +829,32 @@ void UpdateVehicleTileHash(Vehicle *v, bool remove)
 		if (v->hash_tile_next != nullptr) v->hash_tile_next->hash_tile_prev = &v->hash_tile_next;
 		v->hash_tile_prev = new_hash;
 		*new_hash = v;
+		if (v->type == VEH_TRAIN) UpdateTrainTileHashOccupancy(new_hash, v->First()->index, true);
 	}
 
 	/* Remember current hash position */
 	v->hash_tile_current = new_hash;
 }
 
+/**
+ * Check whether the occupancy summaries of the train tile hash buckets match the trains in the tile hash.
+ * @return True if the summaries are valid.
+ */
+bool ValidateTrainTileHashOccupancy()
+{
+	for (uint i = 0; i < TOTAL_HASH_SIZE; i++) {
+		TrainTileHashOccupancy occupancy = {};
+		for (const Vehicle *v = _vehicle_tile_hash[i + TOTAL_HASH_SIZE * VEH_TRAIN]; v != nullptr; v = v->hash_tile_next) {
+			uint64 id = v->First()->index;
+			occupancy.count++;
+			occupancy.sum += id;
+			occupancy.sum_sq += id * id;
+		}
+		if (memcmp(&occupancy, &_train_tile_hash_occupancy[i], sizeof(TrainTileHashOccupancy)) != 0) return false;
+	}
+	return true;
+}
+
 bool ValidateVehicleTileHash(const Vehicle *v)
 {
 	if ((v->type == VEH_TRAIN && Train::From(v)->IsVirtual()) || v->type >= VEH_COMPANY_END) return v->hash_tile_current == nullptr;
@@ -775,6 +897,7 @@ void ResetVehicleHash()
 	for (Vehicle *v : Vehicle::Iterate()) { v->hash_tile_current = nullptr; }
 	memset(_vehicle_viewport_hash, 0, sizeof(_vehicle_viewport_hash));
 	memset(_vehicle_tile_hash, 0, sizeof(_vehicle_tile_hash));
+	memset(_train_tile_hash_occupancy, 0, sizeof(_train_tile_hash_occupancy));
 }
 
 void ResetVehicleColourMap()
@@ -919,6 +1042,8 @@ void Vehicle::PreDestructor()
 		assert(this->cargo_payment == nullptr); // cleared by ~CargoPayment
 	}
 
+	/* Also removes virtual vehicles, which are in the primary vehicle indices but not counted. */
+	UnindexPrimaryVehicle(this);
 	if (this->IsEngineCountable()) {
 		GroupStatistics::CountEngine(this, -1);
 		if (this->IsPrimaryVehicle()) GroupStatistics::CountVehicle(this, -1);
@@ -1030,6 +1155,7 @@ Vehicle::~Vehicle()
 void Vehicle::PreCleanPool()
 {
 	pending_speed_restriction_change_map.clear();
+	ClearPrimaryVehicleIndex();
 }
 
 /**
@@ -1280,6 +1406,8 @@ void CallVehicleTicks()
 	}
 	{
 		PerformanceMeasurer framerate(PFE_GL_TRAINS);
+		_last_tick_train_collision_check_stats = _train_collision_check_stats;
+		_train_collision_check_stats = {};
 		for (Train *t :  _tick_train_too_heavy_cache) {
 			if (HasBit(t->flags, VRF_TOO_HEAVY)) {
 				if (t->owner == _local_company) {
@@ -3620,6 +3748,19 @@ void Vehicle::ShowVisualEffect() const
 	if (sound) PlayVehicleSound(this, VSE_VISUAL_EFFECT);
 }
 
+/**
+ * Set the first vehicle of the chain of this vehicle.
+ * @param first The new first vehicle.
+ */
+void Vehicle::SetFirst(Vehicle *first)
+{
+	if (this->type == VEH_TRAIN && this->hash_tile_current != nullptr && this->first != first) {
+		UpdateTrainTileHashOccupancy(this->hash_tile_current, this->first->index, false);
+		UpdateTrainTileHashOccupancy(this->hash_tile_current, first->index, true);
+	}
+	this->first = first;
+}
+
 /**
  * Set the next vehicle of this vehicle.
  * @param next the next vehicle. nullptr removes the next vehicle.
@@ -3631,7 +3772,7 @@ void Vehicle::SetNext(Vehicle *next)
 	if (this->next != nullptr) {
 		/* We had an old next vehicle. Update the first and previous pointers */
 		for (Vehicle *v = this->next; v != nullptr; v = v->Next()) {
-			v->first = this->next;
+			v->SetFirst(this->next);
 		}
 		this->next->previous = nullptr;
 	}
@@ -3643,7 +3784,7 @@ void Vehicle::SetNext(Vehicle *next)
 		if (this->next->previous != nullptr) this->next->previous->next = nullptr;
 		this->next->previous = this;
 		for (Vehicle *v = this->next; v != nullptr; v = v->Next()) {
-			v->first = this->first;
+			v->SetFirst(this->first);
 		}
 	}
 }
@@ -3805,6 +3946,7 @@ char *Vehicle::DumpVehicleFlags(char *b, const char *last) const
 	dump('l', HasBit(this->vcache.cached_veh_flags, VCF_LAST_VISUAL_EFFECT));
 	dump('z', HasBit(this->vcache.cached_veh_flags, VCF_GV_ZERO_SLOPE_RESIST));
 	dump('d', HasBit(this->vcache.cached_veh_flags, VCF_IS_DRAWN));
+	dump('r', HasBit(this->vcache.cached_veh_flags, VCF_GV_SLOPE_RESIST_VALID));
 	if (this->IsGroundVehicle()) {
 		uint16 gv_flags = this->GetGroundVehicleFlags();
 		b += seprintf(b, last, ", gvf:");
@@ -4065,4 +4207,7 @@ void DumpVehicleStats(char *buffer, const char *last)
 		line(it.second.template_train, "tmpl train");
 		buffer += seprintf(buffer, last, "\n");
 	}
+
+	buffer += seprintf(buffer, last, "Train collision checks in last tick: narrow phase: %u, avoided: %u\n",
+			_last_tick_train_collision_check_stats.narrow_phase, _last_tick_train_collision_check_stats.avoided);
 }
@@ -136,6 +136,7 @@ enum VehicleCacheFlags {
 	VCF_LAST_VISUAL_EFFECT      = 0, ///< Last vehicle in the consist with a visual effect.
 	VCF_GV_ZERO_SLOPE_RESIST    = 1, ///< GroundVehicle: Consist has zero slope resistance (valid only for the first engine), may be false negative.
 	VCF_IS_DRAWN                = 2, ///< Vehicle is currently drawn
+	VCF_GV_SLOPE_RESIST_VALID   = 3, ///< GroundVehicle: Cached total slope resistance of the consist is valid (valid only for the first engine).
 };
 
 /** Cached often queried values common to all vehicles. */
@@ -255,6 +256,25 @@ public:
 
 	TileIndex tile;                     ///< Current tile index
 
+	/* The members below are used for every vehicle part on every tick, they are kept
+	 * together so the tick loops touch as few cache lines per vehicle part as possible. */
+	int32 x_pos;                        ///< x coordinate.
+	int32 y_pos;                        ///< y coordinate.
+	int32 z_pos;                        ///< z coordinate.
+	Direction direction;                ///< facing
+	byte vehstatus;                     ///< Status
+	byte subtype;                       ///< subtype (Filled with values from #AircraftSubType/#DisasterSubType/#EffectVehicleType/#GroundVehicleSubtypeFlags)
+	byte progress;                      ///< The percentage (if divided by 256) this vehicle already crossed the tile unit.
+	uint16 cur_speed;                   ///< current speed
+	byte subspeed;                      ///< fractional speed
+	byte acceleration;                  ///< used by train & aircraft
+	uint32 motion_counter;              ///< counter to occasionally play a vehicle sound.
+	byte tick_counter;                  ///< Increased by one for each tick
+	byte breakdown_ctr;                 ///< Counter for managing breakdown events. @see Vehicle::HandleBreakdown
+	uint16 cargo_age_counter;           ///< Ticks till cargo is aged next.
+	uint16 running_ticks;               ///< Number of ticks this vehicle was not stopped this day
+	VehicleCache vcache;                ///< Cache of often used vehicle values.
+
 	/**
 	 * Heading for this tile.
 	 * For airports and train stations this tile does not necessarily belong to the destination station,
@@ -293,16 +313,10 @@ public:
 	Date date_of_last_service;          ///< Last date the vehicle had a service at a depot.
 	uint16 reliability;                 ///< Reliability.
 	uint16 reliability_spd_dec;         ///< Reliability decrease speed.
-	byte breakdown_ctr;                 ///< Counter for managing breakdown events. @see Vehicle::HandleBreakdown
 	byte breakdown_delay;               ///< Counter for managing breakdown length.
 	byte breakdowns_since_last_service; ///< Counter for the amount of breakdowns.
 	byte breakdown_chance;              ///< Current chance of breakdowns.
 
-	int32 x_pos;                        ///< x coordinate.
-	int32 y_pos;                        ///< y coordinate.
-	int32 z_pos;                        ///< z coordinate.
-	Direction direction;                ///< facing
-
 	Owner owner;                        ///< Which company owns the vehicle?
 	/**
 	 * currently displayed sprite index
@@ -324,12 +338,6 @@ public:
 	TextEffectID fill_percent_te_id;    ///< a text-effect id to a loading indicator object
 	UnitID unitnumber;                  ///< unit number, for display purposes only
 
-	uint16 cur_speed;                   ///< current speed
-	byte subspeed;                      ///< fractional speed
-	byte acceleration;                  ///< used by train & aircraft
-	uint32 motion_counter;              ///< counter to occasionally play a vehicle sound.
-	byte progress;                      ///< The percentage (if divided by 256) this vehicle already crossed the tile unit.
-
 	byte random_bits;                   ///< Bits used for determining which randomized variational spritegroups to use when drawing.
 	byte waiting_triggers;              ///< Triggers to be yet matched before rerandomizing the random bits.
 
@@ -341,14 +349,9 @@ public:
 	uint16 cargo_cap;                   ///< total capacity
 	uint16 refit_cap;                   ///< Capacity left over from before last refit.
 	VehicleCargoList cargo;             ///< The cargo this vehicle is carrying
-	uint16 cargo_age_counter;           ///< Ticks till cargo is aged next.
 	int8 trip_occupancy;                ///< NOSAVE: Occupancy of vehicle of the current trip (updated after leaving a station).
 
 	byte day_counter;                   ///< Increased by one for each day
-	byte tick_counter;                  ///< Increased by one for each tick
-	uint16 running_ticks;               ///< Number of ticks this vehicle was not stopped this day
-
-	byte vehstatus;                     ///< Status
 
 	uint8 order_occupancy_average;      ///< NOSAVE: order occupancy average. 0 = invalid, 1 = n/a, 16-116 = 0-100%
 	Order current_order;                ///< The current order (+ status, like: loading)
@@ -360,11 +363,9 @@ public:
 
 	uint16 load_unload_ticks;           ///< Ticks to wait before starting next cycle.
 	GroupID group_id;                   ///< Index of group Pool array
-	byte subtype;                       ///< subtype (Filled with values from #AircraftSubType/#DisasterSubType/#EffectVehicleType/#GroundVehicleSubtypeFlags)
 	Direction cur_image_valid_dir;      ///< NOSAVE: direction for which cur_image does not need to be regenerated on the next tick
 
 	NewGRFCache grf_cache;              ///< Cache of often used calculated NewGRF values
-	VehicleCache vcache;                ///< Cache of often used vehicle values.
 
 	Vehicle(VehicleType type = VEH_INVALID);
 
@@ -618,7 +619,7 @@ public:
 	Money GetDisplayProfitLifetime() const { return ((this->profit_lifetime + this->profit_this_year) >> 8); }
 
 	void SetNext(Vehicle *next);
-	inline void SetFirst(Vehicle *f) { this->first = f; }
+	void SetFirst(Vehicle *first);
 
 	/**
 	 * Get the next vehicle of this vehicle.
@@ -115,6 +115,17 @@ inline bool HasVehicleOnPosXY(int x, int y, VehicleType type, void *data, Vehicl
 	return VehicleFromPosXY(x, y, type, data, proc, true) != nullptr;
 }
 
+bool IsOnlyTrainNearPosXY(int x, int y, VehicleID first);
+bool IsOnlyTrainOnPos(TileIndex tile, VehicleID first);
+
+/** Statistics of the train collision checks of a tick. */
+struct TrainCollisionCheckStats {
+	uint narrow_phase = 0; ///< Number of checks which looked at the train vehicle parts near the train.
+	uint avoided = 0;      ///< Number of checks which were avoided, because no other train can be near the train.
+};
+
+extern TrainCollisionCheckStats _train_collision_check_stats;
+
 void CallVehicleTicks();
 uint8 CalcPercentVehicleFilled(const Vehicle *v, StringID *colour);
 uint8 CalcPercentVehicleFilledOfCargo(const Vehicle *v, CargoID cargo);
@@ -12,9 +12,126 @@
 #include "vehiclelist.h"
 #include "group.h"
 #include "tracerestrict.h"
+#include "3rdparty/cpp-btree/btree_map.h"
 
 #include "safeguards.h"
 
+/**
+ * Primary vehicles of each company and vehicle type, excluding virtual vehicles.
+ * Entries are added and removed whenever a primary vehicle is counted in or removed from the group statistics, which
+ * includes changes of the owner and the group, and removed when the vehicle is deleted.
+ * Entries are checked again on use, in case a vehicle stopped being primary without being removed from the statistics.
+ */
+static PrimaryVehicleIndex _primary_vehicle_index[MAX_COMPANIES][VEH_COMPANY_END];
+
+/**
+ * Primary vehicles of each company and vehicle type by the group they are directly in, including virtual vehicles.
+ * Maintained like #_primary_vehicle_index, groups without vehicles have no entry.
+ */
+static btree::btree_map<GroupID, PrimaryVehicleIndex> _primary_vehicle_group_index[MAX_COMPANIES][VEH_COMPANY_END];
+
+/**
+ * Add a primary vehicle to the primary vehicle indices of its owner and group.
+ * @param v The vehicle.
+ */
+void IndexPrimaryVehicle(const Vehicle *v)
+{
+	if (v->owner >= MAX_COMPANIES || v->type >= VEH_COMPANY_END) return;
+	if (!HasBit(v->subtype, GVSF_VIRTUAL)) _primary_vehicle_index[v->owner][v->type].insert(v->index);
+	_primary_vehicle_group_index[v->owner][v->type][v->group_id].insert(v->index);
+}
+
+/**
+ * Remove a vehicle from the primary vehicle indices of its owner and group.
+ * @param v The vehicle.
+ */
+void UnindexPrimaryVehicle(const Vehicle *v)
+{
+	if (v->owner >= MAX_COMPANIES || v->type >= VEH_COMPANY_END) return;
+	_primary_vehicle_index[v->owner][v->type].erase(v->index);
+
+	auto &group_index = _primary_vehicle_group_index[v->owner][v->type];
+	auto it = group_index.find(v->group_id);
+	if (it == group_index.end()) return;
+	it->second.erase(v->index);
+	if (it->second.empty()) group_index.erase(it);
+}
+
+/**
+ * Clear the primary vehicle indices of all companies.
+ */
+void ClearPrimaryVehicleIndex()
+{
+	for (auto &company_index : _primary_vehicle_index) {
+		for (PrimaryVehicleIndex &index : company_index) {
+			index.clear();
+		}
+	}
+	for (auto &company_index : _primary_vehicle_group_index) {
+		for (auto &index : company_index) {
+			index.clear();
+		}
+	}
+}
+
+/**
+ * Get the primary vehicle index of a company and vehicle type.
+ * @param company The company.
+ * @param type The vehicle type.
+ * @return The IDs of the primary vehicles, this may include stale entries, see GetIndexedPrimaryVehicle.
+ */
+const PrimaryVehicleIndex &GetPrimaryVehicleIndex(CompanyID company, VehicleType type)
+{
+	static const PrimaryVehicleIndex empty;
+	if (company >= MAX_COMPANIES || type >= VEH_COMPANY_END) return empty;
+	return _primary_vehicle_index[company][type];
+}
+
+/**
+ * Get a vehicle from the primary vehicle index, if the entry is still valid.
+ * @param id The vehicle ID from the index.
+ * @param company The company of the index.
+ * @param type The vehicle type of the index.
+ * @return The vehicle, or nullptr if it is no longer a non-virtual primary vehicle of the given company and type.
+ */
+const Vehicle *GetIndexedPrimaryVehicle(VehicleID id, CompanyID company, VehicleType type)
+{
+	const Vehicle *v = Vehicle::GetIfValid(id);
+	if (v == nullptr || v->owner != company || v->type != type || !v->IsPrimaryVehicle() || HasBit(v->subtype, GVSF_VIRTUAL)) return nullptr;
+	return v;
+}
+
+/**
+ * Get the primary vehicle index of a group of a company and vehicle type.
+ * @param company The company.
+ * @param type The vehicle type.
+ * @param group The group, which may be #DEFAULT_GROUP.
+ * @return The IDs of the primary vehicles directly in the group, this may include stale entries, see GetIndexedGroupPrimaryVehicle.
+ */
+const PrimaryVehicleIndex &GetPrimaryVehicleGroupIndex(CompanyID company, VehicleType type, GroupID group)
+{
+	static const PrimaryVehicleIndex empty;
+	if (company >= MAX_COMPANIES || type >= VEH_COMPANY_END) return empty;
+	const auto &group_index = _primary_vehicle_group_index[company][type];
+	auto it = group_index.find(group);
+	return it != group_index.end() ? it->second : empty;
+}
+
+/**
+ * Get a vehicle from the primary vehicle index of a group, if the entry is still valid.
+ * @param id The vehicle ID from the index.
+ * @param company The company of the index.
+ * @param type The vehicle type of the index.
+ * @param group The group of the index.
+ * @return The vehicle, or nullptr if it is no longer a primary vehicle of the given company and type in the given group.
+ */
+const Vehicle *GetIndexedGroupPrimaryVehicle(VehicleID id, CompanyID company, VehicleType type, GroupID group)
+{
+	const Vehicle *v = Vehicle::GetIfValid(id);
+	if (v == nullptr || v->owner != company || v->type != type || !v->IsPrimaryVehicle() || v->group_id != group) return nullptr;
+	return v;
+}
+
 /**
  * Pack a VehicleListIdentifier in a single uint32.
  * @return The packed identifier.
@@ -117,28 +234,24 @@ bool GenerateVehicleSortList(VehicleList *list, const VehicleListIdentifier &vli
 	list->clear();
 
 	auto fill_all_vehicles = [&]() {
-		for (const Vehicle *v : Vehicle::Iterate()) {
-			if (!HasBit(v->subtype, GVSF_VIRTUAL) && v->type == vli.vtype && v->owner == vli.company && v->IsPrimaryVehicle()) {
-				list->push_back(v);
-			}
-		}
+		IteratePrimaryVehicles(vli.company, vli.vtype, [&](const Vehicle *v) {
+			list->push_back(v);
+		});
 	};
 
 	switch (vli.type) {
 		case VL_STATION_LIST:
-			for (const Vehicle *v : Vehicle::Iterate()) {
-				if (v->type == vli.vtype && v->IsPrimaryVehicle()) {
-					const Order *order;
-
-					FOR_VEHICLE_ORDERS(v, order) {
-						if ((order->IsType(OT_GOTO_STATION) || order->IsType(OT_GOTO_WAYPOINT) || order->IsType(OT_IMPLICIT))
-								&& order->GetDestination() == vli.index) {
-							list->push_back(v);
-							break;
-						}
+			IteratePrimaryVehicles(vli.vtype, [&](const Vehicle *v) {
+				const Order *order;
+
+				FOR_VEHICLE_ORDERS(v, order) {
+					if ((order->IsType(OT_GOTO_STATION) || order->IsType(OT_GOTO_WAYPOINT) || order->IsType(OT_IMPLICIT))
+							&& order->GetDestination() == vli.index) {
+						list->push_back(v);
+						break;
 					}
 				}
-			}
+			});
 			break;
 
 		case VL_SHARED_ORDERS: {
@@ -154,11 +267,17 @@ bool GenerateVehicleSortList(VehicleList *list, const VehicleListIdentifier &vli
 
 		case VL_GROUP_LIST:
 			if (vli.index != ALL_GROUP) {
-				for (const Vehicle *v : Vehicle::Iterate()) {
-					if (!HasBit(v->subtype, GVSF_VIRTUAL) && v->type == vli.vtype && v->IsPrimaryVehicle() &&
-							v->owner == vli.company && GroupIsInGroup(v->group_id, vli.index)) {
-						list->push_back(v);
-					}
+				auto add_group = [&](GroupID group) {
+					IterateGroupPrimaryVehicles(vli.company, vli.vtype, group, [&](const Vehicle *v) {
+						if (!HasBit(v->subtype, GVSF_VIRTUAL)) list->push_back(v);
+					});
+				};
+				if (!Group::IsValidID(vli.index)) {
+					add_group(vli.index);
+					break;
+				}
+				for (const Group *g : Group::Iterate()) {
+					if (g->owner == vli.company && g->vehicle_type == vli.vtype && GroupIsInGroup(g->index, vli.index)) add_group(g->index);
 				}
 				break;
 			}
@@ -170,18 +289,16 @@ bool GenerateVehicleSortList(VehicleList *list, const VehicleListIdentifier &vli
 			break;
 
 		case VL_DEPOT_LIST:
-			for (const Vehicle *v : Vehicle::Iterate()) {
-				if (v->type == vli.vtype && v->IsPrimaryVehicle()) {
-					const Order *order;
-
-					FOR_VEHICLE_ORDERS(v, order) {
-						if (order->IsType(OT_GOTO_DEPOT) && !(order->GetDepotActionType() & ODATFB_NEAREST_DEPOT) && order->GetDestination() == vli.index) {
-							list->push_back(v);
-							break;
-						}
+			IteratePrimaryVehicles(vli.vtype, [&](const Vehicle *v) {
+				const Order *order;
+
+				FOR_VEHICLE_ORDERS(v, order) {
+					if (order->IsType(OT_GOTO_DEPOT) && !(order->GetDepotActionType() & ODATFB_NEAREST_DEPOT) && order->GetDestination() == vli.index) {
+						list->push_back(v);
+						break;
 					}
 				}
-			}
+			});
 			break;
 
 		case VL_SLOT_LIST: {
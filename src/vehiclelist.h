@@ -14,6 +14,8 @@
 #include "vehicle_type.h"
 #include "company_type.h"
 #include "tile_type.h"
+#include "group_type.h"
+#include "3rdparty/cpp-btree/btree_set.h"
 
 /** Vehicle List type flags */
 enum VehicleListType {
@@ -58,4 +60,60 @@ bool GenerateVehicleSortList(VehicleList *list, const VehicleListIdentifier &ide
 void BuildDepotVehicleList(VehicleType type, TileIndex tile, VehicleList *engine_list, VehicleList *wagon_list, bool individual_wagons = false);
 uint GetUnitNumberDigits(VehicleList &vehicles);
 
+/** Set of vehicle IDs, in vehicle ID order. */
+typedef btree::btree_set<VehicleID> PrimaryVehicleIndex;
+
+void IndexPrimaryVehicle(const Vehicle *v);
+void UnindexPrimaryVehicle(const Vehicle *v);
+void ClearPrimaryVehicleIndex();
+const PrimaryVehicleIndex &GetPrimaryVehicleIndex(CompanyID company, VehicleType type);
+const Vehicle *GetIndexedPrimaryVehicle(VehicleID id, CompanyID company, VehicleType type);
+const PrimaryVehicleIndex &GetPrimaryVehicleGroupIndex(CompanyID company, VehicleType type, GroupID group);
+const Vehicle *GetIndexedGroupPrimaryVehicle(VehicleID id, CompanyID company, VehicleType type, GroupID group);
+
+/**
+ * Call a function for each non-virtual primary vehicle of a company and vehicle type, in vehicle ID order.
+ * @param company Company owning the vehicles.
+ * @param type Type of the vehicles.
+ * @param func Function to call with each vehicle.
+ */
+template <typename F>
+void IteratePrimaryVehicles(CompanyID company, VehicleType type, F func)
+{
+	for (VehicleID id : GetPrimaryVehicleIndex(company, type)) {
+		const Vehicle *v = GetIndexedPrimaryVehicle(id, company, type);
+		if (v != nullptr) func(v);
+	}
+}
+
+/**
+ * Call a function for each non-virtual primary vehicle of a vehicle type, of all companies.
+ * @param type Type of the vehicles.
+ * @param func Function to call with each vehicle.
+ */
+template <typename F>
+void IteratePrimaryVehicles(VehicleType type, F func)
+{
+	for (CompanyID c = COMPANY_FIRST; c < MAX_COMPANIES; c++) {
+		IteratePrimaryVehicles(c, type, func);
+	}
+}
+
+/**
+ * Call a function for each primary vehicle of a company and vehicle type which is directly in the given group.
+ * Unlike #IteratePrimaryVehicles, this includes virtual vehicles.
+ * @param company The company.
+ * @param type The vehicle type.
+ * @param group The group, which may be #DEFAULT_GROUP.
+ * @param func Function to call with each vehicle.
+ */
+template <typename F>
+void IterateGroupPrimaryVehicles(CompanyID company, VehicleType type, GroupID group, F func)
+{
+	for (VehicleID id : GetPrimaryVehicleGroupIndex(company, type, group)) {
+		const Vehicle *v = GetIndexedGroupPrimaryVehicle(id, company, type, group);
+		if (v != nullptr) func(v);
+	}
+}
+
 #endif /* VEHICLELIST_H */
@@ -107,6 +107,7 @@
 #include "tunnelbridge_map.h"
 #include "video/video_driver.hpp"
 #include "scope_info.h"
+#include "spritecache.h"
 
 #include <map>
 #include <vector>
@@ -3112,6 +3113,9 @@ void ViewportDoDraw(ViewPort *vp, int left, int top, int right, int bottom)
 		if (vp->zoom < ZOOM_LVL_OUT_256X) ViewportAddKdtreeSigns(&_vd.dpi, true);
 	} else {
 		/* Classic rendering. */
+		extern bool _gfx_draw_active;
+		if (_gfx_draw_active) BeginAsyncSpriteLoading(_vd.dpi.left, _vd.dpi.top, _vd.dpi.left + _vd.dpi.width, _vd.dpi.top + _vd.dpi.height);
+
 		ViewportAddLandscape();
 		ViewportAddVehicles(&_vd.dpi);
 
@@ -3128,6 +3132,8 @@ void ViewportDoDraw(ViewPort *vp, int left, int top, int right, int bottom)
 		ViewportProcessParentSprites();
 
 		if (_draw_bounding_boxes) ViewportDrawBoundingBoxes(&_vd.parent_sprites_to_sort);
+
+		EndAsyncSpriteLoading();
 	}
 	if (_draw_dirty_blocks && !(HasBit(_viewport_debug_flags, VDF_DIRTY_BLOCK_PER_SPLIT) && vp->zoom < ZOOM_LVL_DRAW_MAP)) {
 		ViewportDrawDirtyBlocks();
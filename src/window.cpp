@@ -9,6 +9,8 @@
 
 #include "stdafx.h"
 #include <stdarg.h>
+#include <algorithm>
+#include <unordered_map>
 #include "company_func.h"
 #include "gfx_func.h"
 #include "console_func.h"
@@ -58,6 +60,90 @@ WindowBase *_z_front_window = nullptr;
 /** List of windows opened at the screen sorted from the back. */
 WindowBase *_z_back_window  = nullptr;
 
+/** Back and front window of the z-ordering of the windows of a window class. */
+struct WindowClassZOrdering {
+	WindowBase *back = nullptr;  ///< Window of the class at the back.
+	WindowBase *front = nullptr; ///< Window of the class at the front.
+};
+
+/**
+ * Windows in the z-ordering of each window class, linked through WindowBase::class_z_front and WindowBase::class_z_back.
+ * Windows are in the z-ordering of their class exactly when they are in the z-ordering of all windows,
+ * so deleted windows stay linked until they are freed, like in the z-ordering of all windows.
+ */
+static std::unordered_map<uint, WindowClassZOrdering> _window_class_z_ordering;
+
+/**
+ * Add a window to the z-ordering of its window class, at the position matching its place in the z-ordering of all windows.
+ * @param w The window, which was just added to the z-ordering of all windows.
+ */
+static void AddWindowToClassZOrdering(WindowBase *w)
+{
+	w->indexed_class = w->window_class;
+	WindowClassZOrdering &order = _window_class_z_ordering[w->indexed_class];
+
+	/* Find the window of the class which is closest behind this window. */
+	WindowBase *v = w->z_back;
+	while (v != nullptr && v->indexed_class != w->indexed_class) v = v->z_back;
+
+	w->class_z_back = v;
+	if (v == nullptr) {
+		w->class_z_front = order.back;
+		order.back = w;
+	} else {
+		w->class_z_front = v->class_z_front;
+		v->class_z_front = w;
+	}
+	if (w->class_z_front == nullptr) {
+		order.front = w;
+	} else {
+		w->class_z_front->class_z_back = w;
+	}
+}
+
+/**
+ * Remove a window from the z-ordering of the window class it was added under.
+ * @param w The window.
+ */
+static void RemoveWindowFromClassZOrdering(WindowBase *w)
+{
+	WindowClassZOrdering &order = _window_class_z_ordering[w->indexed_class];
+
+	if (w->class_z_front == nullptr) {
+		assert(order.front == w);
+		order.front = w->class_z_back;
+	} else {
+		w->class_z_front->class_z_back = w->class_z_back;
+	}
+
+	if (w->class_z_back == nullptr) {
+		assert(order.back == w);
+		order.back = w->class_z_front;
+	} else {
+		w->class_z_back->class_z_front = w->class_z_front;
+	}
+
+	w->class_z_front = w->class_z_back = nullptr;
+}
+
+/**
+ * Call a function for each window of a given window class, from back to front.
+ * Windows may be created, deleted or brought to the front by the called function,
+ * with the same effect on the iteration as for #FOR_ALL_WINDOWS_FROM_BACK.
+ * @param cls Window class.
+ * @param func Function to call with each window.
+ */
+template <typename F>
+static void IterateWindowsOfClass(WindowClass cls, F func)
+{
+	auto it = _window_class_z_ordering.find(cls);
+	if (it == _window_class_z_ordering.end()) return;
+
+	for (WindowBase *v = it->second.back; v != nullptr; v = v->class_z_front) {
+		if (v->window_class == cls) func(static_cast<Window *>(v));
+	}
+}
+
 /** If false, highlight is white, otherwise the by the widget defined colour. */
 bool _window_highlight_colour = false;
 
@@ -1148,12 +1234,11 @@ Window::~Window()
  */
 Window *FindWindowById(WindowClass cls, WindowNumber number)
 {
-	Window *w;
-	FOR_ALL_WINDOWS_FROM_BACK(w) {
-		if (w->window_class == cls && w->window_number == number) return w;
-	}
-
-	return nullptr;
+	Window *found = nullptr;
+	IterateWindowsOfClass(cls, [&](Window *w) {
+		if (found == nullptr && w->window_number == number) found = w;
+	});
+	return found;
 }
 
 /**
@@ -1164,12 +1249,11 @@ Window *FindWindowById(WindowClass cls, WindowNumber number)
  */
 Window *FindWindowByClass(WindowClass cls)
 {
-	Window *w;
-	FOR_ALL_WINDOWS_FROM_BACK(w) {
-		if (w->window_class == cls) return w;
-	}
-
-	return nullptr;
+	Window *found = nullptr;
+	IterateWindowsOfClass(cls, [&](Window *w) {
+		if (found == nullptr) found = w;
+	});
+	return found;
 }
 
 /**
@@ -1193,17 +1277,12 @@ void DeleteWindowById(WindowClass cls, WindowNumber number, bool force)
  */
 void DeleteWindowByClass(WindowClass cls)
 {
-	Window *w;
-
-restart_search:
 	/* When we find the window to delete, we need to restart the search
 	 * as deleting this window could cascade in deleting (many) others
 	 * anywhere in the z-array */
-	FOR_ALL_WINDOWS_FROM_BACK(w) {
-		if (w->window_class == cls) {
-			delete w;
-			goto restart_search;
-		}
+	Window *w;
+	while ((w = FindWindowByClass(cls)) != nullptr) {
+		delete w;
 	}
 }
 
@@ -1433,6 +1512,8 @@ static void AddWindowToZOrdering(Window *w)
 			v->z_front = w;
 		}
 	}
+
+	AddWindowToClassZOrdering(w);
 }
 
 
@@ -1442,6 +1523,8 @@ static void AddWindowToZOrdering(Window *w)
  */
 static void RemoveWindowFromZOrdering(WindowBase *w)
 {
+	RemoveWindowFromClassZOrdering(w);
+
 	if (w->z_front == nullptr) {
 		assert(_z_front_window == w);
 		_z_front_window = w->z_back;
@@ -1859,6 +1942,19 @@ void Window::CreateNestedTree(bool fill_nested)
 	}
 }
 
+/**
+ * Change the window class of an initialised window.
+ * @param cls New window class.
+ */
+void Window::ChangeWindowClass(WindowClass cls)
+{
+	if (this->window_class == cls) return;
+
+	RemoveWindowFromClassZOrdering(this);
+	this->window_class = cls;
+	AddWindowToClassZOrdering(this);
+}
+
 /**
  * Perform the second part of the initialization of a nested widget tree.
  * @param window_number Number of the new window.
@@ -1949,6 +2045,8 @@ void UnInitWindowSystem()
 
 	_z_front_window = nullptr;
 	_z_back_window = nullptr;
+
+	_window_class_z_ordering.clear();
 }
 
 /**
@@ -3282,10 +3380,9 @@ void UpdateWindows()
  */
 void SetWindowDirty(WindowClass cls, WindowNumber number)
 {
-	Window *w;
-	FOR_ALL_WINDOWS_FROM_BACK(w) {
-		if (w->window_class == cls && w->window_number == number) w->SetDirty();
-	}
+	IterateWindowsOfClass(cls, [&](Window *w) {
+		if (w->window_number == number) w->SetDirty();
+	});
 }
 
 /**
@@ -3296,12 +3393,9 @@ void SetWindowDirty(WindowClass cls, WindowNumber number)
  */
 void SetWindowWidgetDirty(WindowClass cls, WindowNumber number, byte widget_index)
 {
-	Window *w;
-	FOR_ALL_WINDOWS_FROM_BACK(w) {
-		if (w->window_class == cls && w->window_number == number) {
-			w->SetWidgetDirty(widget_index);
-		}
-	}
+	IterateWindowsOfClass(cls, [&](Window *w) {
+		if (w->window_number == number) w->SetWidgetDirty(widget_index);
+	});
 }
 
 /**
@@ -3310,10 +3404,9 @@ void SetWindowWidgetDirty(WindowClass cls, WindowNumber number, byte widget_inde
  */
 void SetWindowClassesDirty(WindowClass cls)
 {
-	Window *w;
-	FOR_ALL_WINDOWS_FROM_BACK(w) {
-		if (w->window_class == cls) w->SetDirty();
-	}
+	IterateWindowsOfClass(cls, [&](Window *w) {
+		w->SetDirty();
+	});
 }
 
 /**
@@ -3325,8 +3418,10 @@ void Window::InvalidateData(int data, bool gui_scope)
 {
 	this->SetDirty();
 	if (!gui_scope) {
-		/* Schedule GUI-scope invalidation for next redraw. */
-		this->scheduled_invalidation_data.push_back(data);
+		/* Schedule GUI-scope invalidation for next redraw.
+		 * An invalidation with data which is already scheduled is only processed once. */
+		std::vector<int> &scheduled = this->scheduled_invalidation_data;
+		if (std::find(scheduled.begin(), scheduled.end(), data) == scheduled.end()) scheduled.push_back(data);
 	}
 	this->OnInvalidateData(data, gui_scope);
 }
@@ -3383,12 +3478,9 @@ void Window::ProcessHighlightedInvalidations()
  */
 void InvalidateWindowData(WindowClass cls, WindowNumber number, int data, bool gui_scope)
 {
-	Window *w;
-	FOR_ALL_WINDOWS_FROM_BACK(w) {
-		if (w->window_class == cls && w->window_number == number) {
-			w->InvalidateData(data, gui_scope);
-		}
-	}
+	IterateWindowsOfClass(cls, [&](Window *w) {
+		if (w->window_number == number) w->InvalidateData(data, gui_scope);
+	});
 }
 
 /**
@@ -3401,13 +3493,9 @@ void InvalidateWindowData(WindowClass cls, WindowNumber number, int data, bool g
  */
 void InvalidateWindowClassesData(WindowClass cls, int data, bool gui_scope)
 {
-	Window *w;
-
-	FOR_ALL_WINDOWS_FROM_BACK(w) {
-		if (w->window_class == cls) {
-			w->InvalidateData(data, gui_scope);
-		}
-	}
+	IterateWindowsOfClass(cls, [&](Window *w) {
+		w->InvalidateData(data, gui_scope);
+	});
 }
 
 /**
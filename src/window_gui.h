@@ -289,7 +289,10 @@ enum TooltipCloseCondition {
 struct WindowBase {
 	WindowBase *z_front;             ///< The window in front of us in z-order.
 	WindowBase *z_back;              ///< The window behind us in z-order.
+	WindowBase *class_z_front;       ///< The window of the same indexed class in front of us in z-order.
+	WindowBase *class_z_back;        ///< The window of the same indexed class behind us in z-order.
 	WindowClass window_class;        ///< Window class
+	WindowClass indexed_class;       ///< Window class under which the window is linked into the z-ordering of its class.
 
 	virtual ~WindowBase() {}
 
@@ -411,6 +414,7 @@ public:
 	void InitNested(WindowNumber number = 0);
 	void CreateNestedTree(bool fill_nested = true);
 	void FinishInitNested(WindowNumber window_number = 0);
+	void ChangeWindowClass(WindowClass cls);
 
 	/**
 	 * Set the timeout flag of the window and initiate the timer.